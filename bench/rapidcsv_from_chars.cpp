@@ -0,0 +1,119 @@
+// Times rapidcsv's from_chars conversion of numeric cells (`ConverterParams`
+// with `mNumericLocale` false) against the std::sto* and istringstream
+// conversion it replaced, which is reproduced here as it was.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -Idays_cpp bench/rapidcsv_from_chars.cpp -o rapidcsv_from_chars
+// and run `rapidcsv_from_chars [CELLS]` (default 1000000).
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rapidcsv.h"
+
+namespace
+{
+	constexpr int repeats = 5;
+
+	template <typename Run>
+	double bestOf(Run run)
+	{
+		double best = 1e300;
+		for (int i{ 0 }; i < repeats; i++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			run();
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+
+	double streamDouble(const std::string& text)
+	{
+		std::istringstream iss(text);
+		double value{};
+		iss >> value;
+		if (iss.fail() || iss.bad() || !iss.eof())
+		{
+			throw std::invalid_argument("istringstream: no conversion");
+		}
+		return value;
+	}
+
+	void report(const char* name, double before, double after, bool same)
+	{
+		std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(8) << before << " ms -> " << std::setw(6) << after << " ms"
+			<< (same ? "" : " (results differ)") << '\n';
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t cells = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::vector<std::string> integers;
+	std::vector<std::string> doubles;
+	for (std::size_t i{ 0 }; i < cells; i++)
+	{
+		integers.push_back(std::to_string(static_cast<long long>(i * 7919 % 1000003) - 500000));
+		doubles.push_back(std::to_string(static_cast<double>(i) * 0.731));
+	}
+
+	const rapidcsv::ConverterParams params(false, 0, 0, false);
+	std::cout << cells << " cells, best of " << repeats << ", std::sto*/istringstream vs from_chars\n";
+
+	long long streamSum = 0;
+	long long charsSum = 0;
+	const double intStreams = bestOf([&]
+		{
+			streamSum = 0;
+			for (const auto& cell : integers)
+			{
+				streamSum += std::stoi(cell);
+			}
+		});
+	const double intChars = bestOf([&]
+		{
+			const rapidcsv::Converter<int> converter(params);
+			charsSum = 0;
+			for (const auto& cell : integers)
+			{
+				int value;
+				converter.ToVal(cell, value);
+				charsSum += value;
+			}
+		});
+	report("int", intStreams, intChars, streamSum == charsSum);
+
+	double streamTotal = 0;
+	double charsTotal = 0;
+	const double doubleStreams = bestOf([&]
+		{
+			streamTotal = 0;
+			for (const auto& cell : doubles)
+			{
+				streamTotal += streamDouble(cell);
+			}
+		});
+	const double doubleChars = bestOf([&]
+		{
+			const rapidcsv::Converter<double> converter(params);
+			charsTotal = 0;
+			for (const auto& cell : doubles)
+			{
+				double value;
+				converter.ToVal(cell, value);
+				charsTotal += value;
+			}
+		});
+	report("double", doubleStreams, doubleChars, streamTotal == charsTotal);
+	return 0;
+}
@@ -0,0 +1,135 @@
+// Times the specialized scan kernels of `Query::execute()` against the
+// generic per-row loop (`Query::matches()`) on a generated calendar.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -Idays_cpp bench/scan_kernels.cpp days_cpp/EventTable.cpp days_cpp/Query.cpp
+//       days_cpp/DescriptionIndex.cpp days_cpp/Regex.cpp days_cpp/RoaringBitmap.cpp days_cpp/Simd.cpp
+//       days_cpp/Event.cpp days_cpp/Utilities.cpp -o scan_kernels
+// (GCC also needs -fpermissive for Utilities.cpp)
+// and run `scan_kernels [ROWS]` (default 1000000). The table has no dense
+// columns, so `execute()` takes the kernel path; every field is touched
+// once first, so both loops read parsed cells. On more than one core the
+// kernel time also includes the split of the scan across threads.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EventTable.h"
+#include "Query.h"
+
+namespace
+{
+	constexpr int repeats = 5;
+
+	std::pmr::string generateCalendar(std::size_t rows)
+	{
+		std::pmr::string text{ "date,category,description\n" };
+		const std::chrono::sys_days first{ std::chrono::year{ 2020 } / 1 / 1 };
+		for (std::size_t i{ 0 }; i < rows; i++)
+		{
+			const std::chrono::year_month_day date{ first + std::chrono::days{ static_cast<int>((i * 7919) % 3000) } };
+			char day[16];
+			std::snprintf(day, sizeof(day), "%04d-%02u-%02u", static_cast<int>(date.year()),
+				static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+			text += day;
+			text += ',';
+			if (i % 20 != 0)
+			{
+				text += 'c';
+				text += std::to_string(i % 10);
+			}
+			text += ",event number ";
+			text += std::to_string(i);
+			text += '\n';
+		}
+		return text;
+	}
+
+	template <typename Run>
+	double bestOf(Run run)
+	{
+		double best = 1e300;
+		for (int i{ 0 }; i < repeats; i++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			run();
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	EventTable table;
+	if (!table.load(generateCalendar(rows)))
+	{
+		std::cerr << "could not load the generated calendar\n";
+		return 1;
+	}
+	for (std::size_t row{ 0 }; row < table.size(); row++)
+	{
+		table.date(row);
+		table.category(row);
+		table.description(row);
+	}
+
+	const std::chrono::sys_days today{ std::chrono::year{ 2026 } / 10 / 18 };
+	const std::vector<std::vector<std::string>> queries{
+		{ "--after-date", "2022-01-01" },
+		{ "--categories", "c1,c2,c3" },
+		{ "--categories", "c1,c2", "--exclude", "--before-date", "2025-01-01" },
+		{ "--between", "2021-01-01", "2024-01-01", "--no-category" },
+		{ "--description-prefix", "event number 1" },
+	};
+
+	std::cout << rows << " rows, best of " << repeats << ", generic loop vs kernel\n";
+	for (const auto& args : queries)
+	{
+		std::string error;
+		const auto query = Query::parse(args, error);
+		if (!query.has_value())
+		{
+			std::cerr << error << '\n';
+			return 1;
+		}
+
+		std::size_t generic = 0;
+		std::size_t kernel = 0;
+		const double genericTime = bestOf([&]
+			{
+				std::vector<std::size_t> found;
+				for (std::size_t row{ 0 }; row < table.size(); row++)
+				{
+					if (query->matches(table, row, today))
+					{
+						found.push_back(row);
+					}
+				}
+				generic = found.size();
+			});
+		const double kernelTime = bestOf([&] { kernel = query->execute(table, today).size(); });
+		if (generic != kernel)
+		{
+			std::cerr << "results differ: " << generic << " vs " << kernel << '\n';
+			return 1;
+		}
+
+		std::string text;
+		for (const auto& word : args)
+		{
+			text += (text.empty() ? "" : " ") + word;
+		}
+		std::cout << std::left << std::setw(64) << text << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(8) << genericTime << " ms -> " << std::setw(6) << kernelTime << " ms (" << kernel << " rows)\n";
+	}
+	return 0;
+}
@@ -0,0 +1,40 @@
+#include "Dedupe.h"
+
+#include <chrono>
+#include <cstdint> // for fixed width integers
+#include <optional>
+
+#include "HashIndex.h"
+
+std::vector<std::size_t> findDuplicates(const EventTable& table)
+{
+	std::vector<std::size_t> duplicates;
+	HashIndex index(table.size());
+
+	// Dates are compared as days, like `import --dedupe` does, so `2030-1-1`
+	// and `2030-01-01` are the same date.
+	std::vector<std::int32_t> days(table.size());
+	for (std::size_t row{ 0 }; row < table.size(); row++)
+	{
+		const auto date = table.erased(row) ? std::nullopt : table.date(row);
+		if (!date.has_value())
+		{
+			continue;
+		}
+		days[row] = std::chrono::sys_days{ date.value() }.time_since_epoch().count();
+
+		const std::uint64_t seed = static_cast<std::uint32_t>(days[row]);
+		const std::uint64_t hash = hashBytes(table.description(row), hashBytes(table.category(row), seed));
+		auto same = [&](std::uint32_t other)
+		{
+			return days[other] == days[row]
+				&& table.category(other) == table.category(row)
+				&& table.description(other) == table.description(row);
+		};
+		if (index.insert(static_cast<std::uint32_t>(row), hash, same).has_value())
+		{
+			duplicates.push_back(row);
+		}
+	}
+	return duplicates;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "EventTable.h"
+
+// Finds exact duplicate events in `table` in one pass: rows whose date,
+// category and description all equal those of an earlier row. The first
+// occurrence is kept and is not part of the result. Rows with invalid
+// dates and erased rows are ignored. Dates are compared as days, as in
+// `import --dedupe`. Returns the rows in file order.
+std::vector<std::size_t> findDuplicates(const EventTable& table);
@@ -0,0 +1,188 @@
+#include "DescriptionIndex.h"
+
+#include <algorithm> // for sorting and binary searches
+#include <cstddef>	 // for offsetof
+#include <cstring>	 // for std::memcmp
+#include <fstream>	 // for reading and writing the index file
+#include <utility>	 // for std::move
+
+#include "FileStamp.h"
+
+namespace
+{
+	constexpr char magic[8] = { 'D', 'A', 'Y', 'S', 'D', 'S', 'C', '1' };
+
+	struct Header
+	{
+		char magic[8];
+		FileStamp stamp; // of the events file the index belongs to
+		std::uint64_t rows;
+	};
+
+	std::filesystem::path indexPathFor(const std::filesystem::path& eventsPath)
+	{
+		std::filesystem::path path = eventsPath;
+		path += ".descriptions";
+		return path;
+	}
+
+	bool readHeader(std::istream& input, Header& header)
+	{
+		input.read(reinterpret_cast<char*>(&header), sizeof(header));
+		return input && std::memcmp(header.magic, magic, sizeof(magic)) == 0;
+	}
+}
+
+DescriptionIndex::DescriptionIndex(const EventTable& source)
+	: table(source)
+	, rows(source.size())
+{
+	for (std::size_t row{ 0 }; row < rows.size(); row++)
+	{
+		rows[row] = static_cast<std::uint32_t>(row);
+	}
+	std::stable_sort(rows.begin(), rows.end(), [this](std::uint32_t a, std::uint32_t b)
+		{
+			return table.description(a) < table.description(b);
+		});
+}
+
+DescriptionIndex::DescriptionIndex(const EventTable& source, std::vector<std::uint32_t> sorted)
+	: table(source)
+	, rows(std::move(sorted))
+{
+}
+
+std::unique_ptr<DescriptionIndex> DescriptionIndex::open(const EventTable& table, const std::filesystem::path& eventsPath)
+{
+	auto index = load(table, eventsPath);
+	// Appended rows are scanned; rebuild once they are a sizable share.
+	if (index && table.size() - index->rows.size() <= std::max<std::size_t>(4096, index->rows.size() / 8))
+	{
+		return index;
+	}
+
+	index = std::make_unique<DescriptionIndex>(table);
+	index->write(eventsPath);
+	return index;
+}
+
+std::unique_ptr<DescriptionIndex> DescriptionIndex::load(const EventTable& table, const std::filesystem::path& eventsPath)
+{
+	if (!isCurrent(eventsPath))
+	{
+		return nullptr;
+	}
+
+	// The file may be truncated or corrupt: its size has to match the row
+	// count, and the rows have to be a permutation of rows of the table.
+	const auto indexPath = indexPathFor(eventsPath);
+	std::error_code error;
+	const std::uint64_t fileSize = std::filesystem::file_size(indexPath, error);
+	std::ifstream input(indexPath, std::ios::binary);
+	Header header{};
+	if (error || !readHeader(input, header) || header.rows > table.size()
+		|| fileSize != sizeof(header) + header.rows * sizeof(std::uint32_t))
+	{
+		return nullptr;
+	}
+	std::vector<std::uint32_t> sorted(header.rows);
+	input.read(reinterpret_cast<char*>(sorted.data()), static_cast<std::streamsize>(sorted.size() * sizeof(std::uint32_t)));
+	if (!input)
+	{
+		return nullptr;
+	}
+	std::vector<bool> seen(sorted.size(), false);
+	for (std::uint32_t row : sorted)
+	{
+		if (row >= sorted.size() || seen[row])
+		{
+			return nullptr;
+		}
+		seen[row] = true;
+	}
+	return std::unique_ptr<DescriptionIndex>(new DescriptionIndex(table, std::move(sorted)));
+}
+
+bool DescriptionIndex::write(const std::filesystem::path& eventsPath) const
+{
+	Header header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.stamp = FileStamp::of(eventsPath);
+	header.rows = rows.size();
+
+	const auto indexPath = indexPathFor(eventsPath);
+	std::filesystem::path tempPath = indexPath;
+	tempPath += ".tmp";
+	{
+		std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(rows.data()), static_cast<std::streamsize>(rows.size() * sizeof(std::uint32_t)));
+		output.close();
+		if (!output)
+		{
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tempPath, indexPath, error);
+	return !error;
+}
+
+std::vector<std::size_t> DescriptionIndex::withPrefix(std::string_view prefix) const
+{
+	// Cutting every description to the length of the prefix keeps the array
+	// sorted, and the matches are exactly the cut descriptions equal to it.
+	auto cut = [&](std::uint32_t row) { return table.description(row).substr(0, prefix.size()); };
+	const auto first = std::lower_bound(rows.begin(), rows.end(), prefix,
+		[&](std::uint32_t row, std::string_view value) { return cut(row) < value; });
+	const auto last = std::upper_bound(first, rows.end(), prefix,
+		[&](std::string_view value, std::uint32_t row) { return value < cut(row); });
+
+	std::vector<std::size_t> matches;
+	matches.reserve(static_cast<std::size_t>(last - first));
+	for (auto it = first; it != last; ++it)
+	{
+		if (!table.erased(*it))
+		{
+			matches.push_back(*it);
+		}
+	}
+	std::sort(matches.begin(), matches.end());
+
+	// Rows appended after the index was built.
+	for (std::size_t row{ rows.size() }; row < table.size(); row++)
+	{
+		if (!table.erased(row) && table.description(row).starts_with(prefix))
+		{
+			matches.push_back(row);
+		}
+	}
+	return matches;
+}
+
+bool DescriptionIndex::covers(const EventTable& other) const
+{
+	return &other == &table && rows.size() == table.size();
+}
+
+bool DescriptionIndex::isCurrent(const std::filesystem::path& eventsPath)
+{
+	std::ifstream input(indexPathFor(eventsPath), std::ios::binary);
+	Header header{};
+	return readHeader(input, header) && header.stamp == FileStamp::of(eventsPath);
+}
+
+void DescriptionIndex::restamp(const std::filesystem::path& eventsPath)
+{
+	std::fstream file(indexPathFor(eventsPath), std::ios::binary | std::ios::in | std::ios::out);
+	const FileStamp stamp = FileStamp::of(eventsPath);
+	file.seekp(offsetof(Header, stamp));
+	file.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+}
+
+void DescriptionIndex::invalidate(const std::filesystem::path& eventsPath)
+{
+	std::error_code error;
+	std::filesystem::remove(indexPathFor(eventsPath), error);
+}
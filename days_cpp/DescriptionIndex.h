@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "EventTable.h"
+
+// Sorted index of the descriptions of an `EventTable` for prefix searches.
+//
+// The index is an array of row numbers ordered by description. All rows
+// whose description starts with a prefix form one contiguous range of that
+// array, found with two binary searches of O(log n) steps that each compare
+// up to |prefix| bytes, so a lookup costs O(|prefix| log n + k log k) for k
+// matches (the last term puts them back in file order) instead of a full
+// scan. Building it is a sort.
+//
+// `days batch` and `days query` build it in memory for their many queries.
+// One-shot commands use the copy persisted next to the events file
+// (`events.csv.descriptions`), stamped with the size and modification time
+// of the file it was built from, like the trigram index. Appending events
+// keeps it usable: `restamp()` updates the stamp, and rows past the indexed
+// ones are scanned until there are enough of them to make a rebuild
+// worthwhile. Rewriting the events file must `invalidate()` it.
+//
+// The index refers to the table and must not outlive it.
+class DescriptionIndex
+{
+public:
+	explicit DescriptionIndex(const EventTable& source);
+
+	// Loads the stored index for `eventsPath` if it is current, otherwise
+	// builds one from `table` and stores it.
+	static std::unique_ptr<DescriptionIndex> open(const EventTable& table, const std::filesystem::path& eventsPath);
+
+	// Loads the stored index for `eventsPath` if it is current; never builds
+	// one. Returns nullptr if there is none.
+	static std::unique_ptr<DescriptionIndex> load(const EventTable& table, const std::filesystem::path& eventsPath);
+
+	// Rows whose description starts with `prefix`, in file order.
+	// Erased rows are left out.
+	std::vector<std::size_t> withPrefix(std::string_view prefix) const;
+
+	// Returns true if the index still covers every row of the table.
+	bool covers(const EventTable& table) const;
+
+	// Returns true if the stored index matches the events file as it is now.
+	static bool isCurrent(const std::filesystem::path& eventsPath);
+
+	// Records the events file as it is now in the stored index. Only call
+	// this if the index was current before events were appended.
+	static void restamp(const std::filesystem::path& eventsPath);
+
+	// Removes the stored index.
+	static void invalidate(const std::filesystem::path& eventsPath);
+
+private:
+	DescriptionIndex(const EventTable& source, std::vector<std::uint32_t> sorted);
+
+	bool write(const std::filesystem::path& eventsPath) const;
+
+	const EventTable& table;
+	std::vector<std::uint32_t> rows; // the first rows.size() rows of the table
+};
@@ -4,10 +4,10 @@ std::chrono::year_month_day Event::getTimestamp() const {
     return timestamp;
 }
 
-std::string Event::getCategory() const {
+std::string_view Event::getCategory() const {
     return category;
 }
 
-std::string Event::getDescription() const {
+std::string_view Event::getDescription() const {
     return description;
 }
\ No newline at end of file
@@ -1,23 +1,28 @@
 #pragma once
 
-#include <string>
+#include <iosfwd>
+#include <string_view>
 #include <chrono>
 
 // Represents an event.
+// The category and description are not copied: they refer to text owned
+// elsewhere, usually the load buffer of an `EventTable`, which has to
+// outlive the event. An event is then a 4-byte date and two views, and
+// materializing or printing one allocates nothing.
 class Event {
 public:
     Event(
         const std::chrono::year_month_day& t,
-        const std::string& c,
-        const std::string& d) :
+        std::string_view c,
+        std::string_view d) :
         timestamp(t), category(c), description(d) {
 
     }
 
     // Getters for the properties:
     std::chrono::year_month_day getTimestamp() const;
-    std::string getCategory() const;
-    std::string getDescription() const;
+    std::string_view getCategory() const;
+    std::string_view getDescription() const;
 
     // Overloaded operator for output stream use.
     // Needs to be `friend`, not a method in this class.
@@ -25,6 +30,6 @@ public:
 
 private:
     std::chrono::year_month_day timestamp;
-    std::string category;
-    std::string description;
+    std::string_view category;
+    std::string_view description;
 };
\ No newline at end of file
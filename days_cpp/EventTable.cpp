@@ -0,0 +1,544 @@
+#include "EventTable.h"
+
+#include <algorithm> // for std::find, std::fill and std::count
+#include <fstream>	 // for reading the file in one go
+#include <iostream>	 // for error reporting
+#include <utility>	 // for std::move
+
+#include "Utilities.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>	 // for syncing the saved file
+#include <io.h>
+#else
+#include <fcntl.h>	 // for syncing the saved file
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Where `date()` collects its messages on this thread, if anywhere.
+	thread_local EventTable::DeferredMessages* deferredMessages = nullptr;
+
+	// Reads `input` to the end in large blocks.
+	void readAll(std::istream& input, std::pmr::string& buffer)
+	{
+		constexpr std::size_t blockSize = 1 << 20;
+		buffer.clear();
+		while (input)
+		{
+			const std::size_t used = buffer.size();
+			buffer.resize(used + blockSize);
+			input.read(buffer.data() + used, blockSize);
+			buffer.resize(used + static_cast<std::size_t>(input.gcount()));
+		}
+	}
+
+	// Reads one CSV cell starting at `pos` and returns its extent. Quoted
+	// cells are unescaped in place (`""` becomes `"`), which can only make
+	// them shorter, so the returned field always stays inside the cell.
+	// On return `pos` points at the separator or line break that ended the cell.
+	std::pair<std::size_t, std::size_t> readCell(std::pmr::string& buf, std::size_t& pos)
+	{
+		const std::size_t start = pos;
+		const std::size_t end = buf.size();
+
+		if (pos < end && buf[pos] == '"')
+		{
+			std::size_t out = start;
+			pos++;
+			while (pos < end)
+			{
+				if (buf[pos] == '"')
+				{
+					if (pos + 1 < end && buf[pos + 1] == '"')
+					{
+						buf[out++] = '"';
+						pos += 2;
+						continue;
+					}
+					pos++;
+					break;
+				}
+				buf[out++] = buf[pos++];
+			}
+			const std::size_t length = out - start;
+			// Anything between the closing quote and the separator is ignored.
+			while (pos < end && buf[pos] != ',' && buf[pos] != '\n')
+			{
+				pos++;
+			}
+			return { start, length };
+		}
+
+		while (pos < end && buf[pos] != ',' && buf[pos] != '\n')
+		{
+			pos++;
+		}
+		std::size_t length = pos - start;
+		if (length > 0 && buf[start + length - 1] == '\r')
+		{
+			length--;
+		}
+		return { start, length };
+	}
+
+	// Flushes the data of the file at `path` to disk.
+	bool syncFile(const std::filesystem::path& path)
+	{
+#if defined(_WIN32)
+		const int fd = _wopen(path.c_str(), _O_WRONLY | _O_BINARY);
+		const bool synced = fd >= 0 && _commit(fd) == 0;
+		if (fd >= 0)
+		{
+			_close(fd);
+		}
+#else
+		const int fd = ::open(path.c_str(), O_WRONLY);
+		const bool synced = fd >= 0 && ::fsync(fd) == 0;
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+#endif
+		return synced;
+	}
+
+	// Flushes the directory entry of `path` to disk after a rename. Best
+	// effort: not every file system supports it, and Windows has no need.
+	void syncDirectory(const std::filesystem::path& path)
+	{
+#if !defined(_WIN32)
+		const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path{ "." };
+		const int fd = ::open(directory.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			::fsync(fd);
+			::close(fd);
+		}
+#endif
+	}
+
+	// Appends `field` to `out`, quoting it if it contains a separator,
+	// a quote or a line break.
+	void appendCsvField(std::string& out, std::string_view field)
+	{
+		if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+		{
+			out += field;
+			return;
+		}
+		out += '"';
+		for (char c : field)
+		{
+			if (c == '"')
+			{
+				out += '"';
+			}
+			out += c;
+		}
+		out += '"';
+	}
+}
+
+EventTable::EventTable(std::pmr::memory_resource* memory)
+	: buffer(memory)
+	, fields(memory)
+	, headerCells(memory)
+	, cells(memory)
+	, rowCellsEnd(memory)
+	, erasedRows(memory)
+	, dates(memory)
+	, dateStates(memory)
+{
+}
+
+bool EventTable::load(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	return load(file);
+}
+
+bool EventTable::load(std::istream& input)
+{
+	std::pmr::string text{ buffer.get_allocator() };
+	readAll(input, text);
+	return load(std::move(text));
+}
+
+bool EventTable::load(std::pmr::string text, std::size_t firstRow)
+{
+	buffer = std::move(text);
+	this->firstRow = firstRow;
+
+	// UTF-8 byte order mark, written by some editors on Windows.
+	std::size_t pos = buffer.starts_with("\xEF\xBB\xBF") ? 3 : 0;
+
+	// Map the header cells to our columns.
+	std::fill(std::begin(columnOf), std::end(columnOf), -1);
+	headerCells.clear();
+	for (int cell = 0; pos < buffer.size(); cell++)
+	{
+		const auto [offset, length] = readCell(buffer, pos);
+		headerCells.push_back(Field{ offset, length });
+		const std::string_view name{ buffer.data() + offset, length };
+		if (name == "date")
+			columnOf[DateColumn] = cell;
+		else if (name == "category")
+			columnOf[CategoryColumn] = cell;
+		else if (name == "description")
+			columnOf[DescriptionColumn] = cell;
+
+		if (pos >= buffer.size() || buffer[pos++] == '\n')
+		{
+			break;
+		}
+	}
+	for (int column : columnOf)
+	{
+		if (column < 0)
+		{
+			std::cerr << "missing date, category or description column\n";
+			return false;
+		}
+	}
+
+	// Index the data rows. Only the offsets of the three columns we know
+	// about are kept, unless the file has other columns, which `save()`
+	// then needs every cell for.
+	// Every record ends at a line break, so counting them bounds the number
+	// of rows, and the row index is allocated once instead of growing.
+	const bool keepCells = headerCells.size() > ColumnCount;
+	if (!keepCells)
+	{
+		headerCells.clear();
+	}
+	cells.clear();
+	rowCellsEnd.clear();
+	fields.clear();
+	fields.reserve(ColumnCount * (static_cast<std::size_t>(std::count(buffer.begin() + static_cast<std::ptrdiff_t>(pos), buffer.end(), '\n')) + 1));
+	rows = 0;
+	while (pos < buffer.size())
+	{
+		if (buffer[pos] == '\n' || (buffer[pos] == '\r' && pos + 1 < buffer.size() && buffer[pos + 1] == '\n'))
+		{
+			pos += buffer[pos] == '\n' ? 1 : 2; // skip empty lines
+			continue;
+		}
+
+		fields.resize(fields.size() + ColumnCount);
+		Field* row = &fields[fields.size() - ColumnCount];
+		for (int cell = 0; ; cell++)
+		{
+			const auto [offset, length] = readCell(buffer, pos);
+			for (int column = 0; column < ColumnCount; column++)
+			{
+				if (columnOf[column] == cell)
+				{
+					row[column] = Field{ offset, length };
+				}
+			}
+			if (keepCells)
+			{
+				cells.push_back(Field{ offset, length });
+			}
+			if (pos >= buffer.size() || buffer[pos++] == '\n')
+			{
+				break;
+			}
+		}
+		if (keepCells)
+		{
+			rowCellsEnd.push_back(cells.size());
+		}
+		rows++;
+	}
+
+	dates.assign(rows, std::chrono::year_month_day{});
+	dateStates.assign(rows, DateState::Unparsed);
+	erasedRows.assign(rows, false);
+	return true;
+}
+
+std::size_t EventTable::size() const
+{
+	return rows;
+}
+
+std::string_view EventTable::field(std::size_t row, Column column) const
+{
+	const Field& f = fields[row * ColumnCount + column];
+	return std::string_view{ buffer.data() + f.offset, f.length };
+}
+
+std::string_view EventTable::dateText(std::size_t row) const
+{
+	return field(row, DateColumn);
+}
+
+std::string_view EventTable::category(std::size_t row) const
+{
+	return field(row, CategoryColumn);
+}
+
+std::string_view EventTable::description(std::size_t row) const
+{
+	return field(row, DescriptionColumn);
+}
+
+std::optional<std::chrono::year_month_day> EventTable::date(std::size_t row) const
+{
+	if (dateStates[row] == DateState::Unparsed)
+	{
+		// Try the allocation free parser first; it handles every date `days`
+		// itself writes. Anything unusual goes through the lenient one.
+		Utilities tools;
+		auto parsed = tools.parseIsoDate(dateText(row));
+		if (!parsed.has_value())
+		{
+			parsed = tools.getDateFromString(std::string{ dateText(row) });
+		}
+		if (parsed.has_value())
+		{
+			dates[row] = parsed.value();
+			dateStates[row] = DateState::Valid;
+		}
+		else
+		{
+			std::string message = "bad date at row " + std::to_string(firstRow + row) + ": ";
+			message += dateText(row);
+			message += '\n';
+			if (deferredMessages != nullptr)
+			{
+				deferredMessages->text += message;
+			}
+			else
+			{
+				std::cerr << message;
+			}
+			dateStates[row] = DateState::Invalid;
+		}
+	}
+
+	if (dateStates[row] == DateState::Invalid)
+	{
+		return std::nullopt;
+	}
+	return dates[row];
+}
+
+EventTable::DeferredMessages::DeferredMessages()
+	: previous(deferredMessages)
+{
+	deferredMessages = this;
+}
+
+EventTable::DeferredMessages::~DeferredMessages()
+{
+	deferredMessages = previous;
+}
+
+void EventTable::buildColumns() const
+{
+	daySerials();
+	categoryIds();
+	columns = true;
+}
+
+bool EventTable::hasColumns() const
+{
+	return columns;
+}
+
+const std::vector<std::int32_t>& EventTable::daySerials() const
+{
+	days.reserve(rows);
+	for (std::size_t row{ days.size() }; row < rows; row++)
+	{
+		const auto parsed = date(row);
+		days.push_back(parsed.has_value()
+			? static_cast<std::int32_t>(std::chrono::sys_days{ parsed.value() }.time_since_epoch().count())
+			: invalidDay);
+	}
+	return days;
+}
+
+const std::vector<std::uint32_t>& EventTable::categoryIds() const
+{
+	categoryColumn.reserve(rows);
+	for (std::size_t row{ categoryColumn.size() }; row < rows; row++)
+	{
+		const std::string_view name = category(row);
+		const auto id = static_cast<std::uint32_t>(categoryDictionary.size());
+		auto existing = categoryLookup.insert(id, hashBytes(name),
+			[&](std::uint32_t other) { return categoryDictionary[other] == name; });
+		if (existing.has_value())
+		{
+			categoryColumn.push_back(existing.value());
+			categoryMembers[existing.value()].append(static_cast<std::uint32_t>(row));
+			continue;
+		}
+
+		categoryDictionary.emplace_back(name);
+		categoryColumn.push_back(id);
+		categoryMembers.emplace_back().append(static_cast<std::uint32_t>(row));
+		if (categoryDictionary.size() == categoryCapacity)
+		{
+			// The index has a fixed capacity; move to one twice as large.
+			categoryCapacity *= 2;
+			categoryLookup = HashIndex(categoryCapacity);
+			for (std::uint32_t known{ 0 }; known < categoryDictionary.size(); known++)
+			{
+				categoryLookup.insert(known, hashBytes(categoryDictionary[known]), [](std::uint32_t) { return false; });
+			}
+		}
+	}
+	return categoryColumn;
+}
+
+const std::vector<std::string>& EventTable::categoryNames() const
+{
+	categoryIds();
+	return categoryDictionary;
+}
+
+const RoaringBitmap& EventTable::categoryRows(std::uint32_t id) const
+{
+	categoryIds();
+	return categoryMembers[id];
+}
+
+std::optional<std::uint32_t> EventTable::categoryId(std::string_view category) const
+{
+	const auto& names = categoryNames();
+	auto found = std::find(names.begin(), names.end(), category);
+	if (found == names.end())
+	{
+		return std::nullopt;
+	}
+	return static_cast<std::uint32_t>(found - names.begin());
+}
+
+Event EventTable::event(std::size_t row) const
+{
+	return Event{ date(row).value(), category(row), description(row) };
+}
+
+void EventTable::append(const std::chrono::year_month_day& date, std::string_view category, std::string_view description)
+{
+	Utilities tools;
+	const std::string dateString = tools.getStringFromDate(date);
+
+	// The new cells go to the end of the buffer; fields refer to them by offset.
+	for (std::string_view cell : { std::string_view{ dateString }, category, description })
+	{
+		fields.push_back(Field{ buffer.size(), cell.size() });
+		buffer += cell;
+	}
+	if (!headerCells.empty())
+	{
+		// The other columns of the file stay empty.
+		const Field* row = &fields[fields.size() - ColumnCount];
+		for (std::size_t cell{ 0 }; cell < headerCells.size(); cell++)
+		{
+			const int* column = std::find(std::begin(columnOf), std::end(columnOf), static_cast<int>(cell));
+			cells.push_back(column != std::end(columnOf) ? row[column - std::begin(columnOf)] : Field{});
+		}
+		rowCellsEnd.push_back(cells.size());
+	}
+	rows++;
+	dates.push_back(date);
+	dateStates.push_back(DateState::Valid);
+	erasedRows.push_back(false);
+}
+
+void EventTable::erase(std::size_t row)
+{
+	erasedRows[row] = true;
+}
+
+bool EventTable::erased(std::size_t row) const
+{
+	return erasedRows[row];
+}
+
+bool EventTable::save(const std::filesystem::path& path) const
+{
+	std::string out;
+	if (headerCells.empty())
+	{
+		out = "date,category,description\n";
+		out.reserve(buffer.size() + out.size());
+		for (std::size_t row{ 0 }; row < rows; row++)
+		{
+			if (erasedRows[row])
+			{
+				continue;
+			}
+			appendCsvRow(out, dateText(row), category(row), description(row));
+		}
+	}
+	else
+	{
+		// Every cell as it was read, so other columns survive.
+		out.reserve(buffer.size() + buffer.size() / 8);
+		const auto appendCells = [&](const Field* first, const Field* last)
+		{
+			for (const Field* cell = first; cell != last; cell++)
+			{
+				if (cell != first)
+				{
+					out += ',';
+				}
+				appendCsvField(out, std::string_view{ buffer.data() + cell->offset, cell->length });
+			}
+			out += '\n';
+		};
+		appendCells(headerCells.data(), headerCells.data() + headerCells.size());
+		for (std::size_t row{ 0 }; row < rows; row++)
+		{
+			if (!erasedRows[row])
+			{
+				appendCells(cells.data() + (row == 0 ? 0 : rowCellsEnd[row - 1]), cells.data() + rowCellsEnd[row]);
+			}
+		}
+	}
+
+	std::filesystem::path tempPath = path;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(out.data(), static_cast<std::streamsize>(out.size()));
+		file.close();
+		if (!file || !syncFile(tempPath))
+		{
+			std::error_code error;
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	syncDirectory(path);
+	return true;
+}
+
+void appendCsvRow(std::string& out, std::string_view date, std::string_view category, std::string_view description)
+{
+	appendCsvField(out, date);
+	out += ',';
+	appendCsvField(out, category);
+	out += ',';
+	appendCsvField(out, description);
+	out += '\n';
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Event.h"
+#include "HashIndex.h"
+#include "RoaringBitmap.h"
+
+// Column-oriented, lazily materialized view of an `events.csv` file.
+//
+// `load()` reads the whole file into one buffer and makes a single pass over
+// it, recording where the date, category and description fields of every
+// row start and end. Nothing is converted or copied at that point: dates are
+// parsed and validated the first time a query asks for them, and the text
+// columns are only turned into `Event` objects for the rows that actually
+// get printed or written.
+class EventTable
+{
+public:
+	// The text, the row index and the date cache of a load are allocated
+	// from `memory`. A caller that loads many tables one after another, like
+	// the chunked `days list`, can pass a `std::pmr::monotonic_buffer_resource`
+	// over one block and release it between tables: a load then makes no
+	// allocator calls, and dropping a table frees nothing piece by piece.
+	explicit EventTable(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+	// Reads and indexes the CSV file at `path`.
+	// Returns false if the file can't be read or lacks one of the columns.
+	bool load(const std::filesystem::path& path);
+
+	// Same as above, for CSV data read from `input` until end of stream.
+	bool load(std::istream& input);
+
+	// Same as above, for CSV data already in memory, which the table takes
+	// over; without a copy if it uses the table's memory resource. When a
+	// large file is loaded piece by piece, `firstRow` is the number of data
+	// rows before this piece; messages count rows from there.
+	bool load(std::pmr::string text, std::size_t firstRow = 0);
+
+	// Number of data rows (the header row is not counted).
+	std::size_t size() const;
+
+	// The date of `row`, or `std::nullopt` if the cell is not a valid
+	// YYYY-MM-DD date. Parsed on first use and cached afterwards; the cache
+	// has one slot per row, so threads may call this for different rows.
+	// A bad date is reported on `std::cerr` when it is parsed, or collected
+	// by the thread's `DeferredMessages`.
+	std::optional<std::chrono::year_month_day> date(std::size_t row) const;
+
+	// While an instance is alive, the messages of `date()` calls on the
+	// creating thread are appended to `text` instead of being printed. A
+	// parallel scan keeps one per chunk and prints them in row order after
+	// the threads are joined.
+	class DeferredMessages
+	{
+	public:
+		DeferredMessages();
+		~DeferredMessages();
+		DeferredMessages(const DeferredMessages&) = delete;
+		DeferredMessages& operator=(const DeferredMessages&) = delete;
+
+		std::string text;
+
+	private:
+		DeferredMessages* previous;
+	};
+
+	// Dense columns for vectorized filters. They cost a pass over the whole
+	// table, so they are only built for tables that answer many queries, as
+	// in `days batch` and `days query`: `buildColumns()` builds them, and
+	// after that `hasColumns()` is true and they are kept up to date when
+	// rows are appended. `daySerials()` holds the date of every row as days
+	// since 1970-01-01, or `invalidDay` if it has no valid date.
+	// `categoryIds()` numbers the distinct categories in order of first
+	// appearance; `categoryNames()` maps the ids back to the names.
+	void buildColumns() const;
+	bool hasColumns() const;
+	static constexpr std::int32_t invalidDay = std::numeric_limits<std::int32_t>::min();
+	const std::vector<std::int32_t>& daySerials() const;
+	const std::vector<std::uint32_t>& categoryIds() const;
+	const std::vector<std::string>& categoryNames() const;
+
+	// The id of `category`, or `std::nullopt` if no row has that category.
+	std::optional<std::uint32_t> categoryId(std::string_view category) const;
+
+	// The rows with category id `id`, as a compressed bitmap. The bitmaps
+	// are built and kept up to date along with `categoryIds()`, so queries
+	// only use them on tables with columns.
+	const RoaringBitmap& categoryRows(std::uint32_t id) const;
+
+	// Views into the load buffer; valid as long as the table is alive.
+	std::string_view dateText(std::size_t row) const;
+	std::string_view category(std::size_t row) const;
+	std::string_view description(std::size_t row) const;
+
+	// Materializes `row` as an `Event`, which refers to the load buffer.
+	// The row must have a valid date.
+	Event event(std::size_t row) const;
+
+	// Adds a new row at the end of the table. Changes only live in memory
+	// until `save()` is called.
+	void append(const std::chrono::year_month_day& date, std::string_view category, std::string_view description);
+
+	// Marks `row` as deleted. The row keeps its index so other row numbers
+	// stay valid, but no filter matches it and `save()` leaves it out.
+	void erase(std::size_t row);
+	bool erased(std::size_t row) const;
+
+	// Writes the whole table to a temporary file next to `path`, flushes it
+	// to disk and then renames it over `path`, so readers, and the file
+	// after a crash, hold either the old or the new data. Columns other than
+	// date, category and description are kept, in their original order, and
+	// are left empty in appended rows.
+	bool save(const std::filesystem::path& path) const;
+
+private:
+	enum Column { DateColumn, CategoryColumn, DescriptionColumn, ColumnCount };
+
+	// Location of one cell inside `buffer`.
+	struct Field
+	{
+		std::size_t offset{ 0 };
+		std::size_t length{ 0 };
+	};
+
+	enum class DateState : char { Unparsed, Valid, Invalid };
+
+	std::string_view field(std::size_t row, Column column) const;
+
+	std::pmr::string buffer;
+	std::pmr::vector<Field> fields; // ColumnCount entries per row
+
+	// Only for files with columns besides ours, so `save()` can write them
+	// back: the header cells, every cell of every row, and where each row's
+	// cells end in `cells`. `columnOf` is the header position of our columns.
+	std::pmr::vector<Field> headerCells;
+	std::pmr::vector<Field> cells;
+	std::pmr::vector<std::size_t> rowCellsEnd;
+	int columnOf[ColumnCount] = { -1, -1, -1 };
+	std::size_t rows{ 0 };
+	std::size_t firstRow{ 0 };
+	std::pmr::vector<bool> erasedRows;
+
+	mutable std::pmr::vector<std::chrono::year_month_day> dates;
+	mutable std::pmr::vector<DateState> dateStates;
+
+	mutable bool columns{ false };
+	mutable std::vector<std::int32_t> days;
+	mutable std::vector<std::uint32_t> categoryColumn;
+	mutable std::vector<std::string> categoryDictionary;
+	mutable std::vector<RoaringBitmap> categoryMembers;
+	mutable std::size_t categoryCapacity{ 64 };
+	mutable HashIndex categoryLookup{ categoryCapacity }; // category ids by name
+};
+
+// Appends one `date,category,description` line to `out`, quoting the
+// fields that contain separators, quotes or line breaks.
+void appendCsvRow(std::string& out, std::string_view date, std::string_view category, std::string_view description);
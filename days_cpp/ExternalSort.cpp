@@ -0,0 +1,499 @@
+#include "ExternalSort.h"
+
+#include <algorithm> // for std::max
+#include <charconv>	 // for parsing the budget
+#include <cstdint>
+#include <cstring>	 // for std::memcpy
+#include <fstream>	 // for the events file and the run files
+#include <iostream>	 // for error reporting
+#include <memory>	 // for std::unique_ptr
+#include <memory_resource> // for the chunk arena
+#include <queue>	 // for the merge
+#include <random>	 // for naming the run directory
+#include <string>
+#include <utility>	 // for std::move
+#include <vector>
+
+#include "EventTable.h"
+
+namespace
+{
+	// The text of a chunk gets a sixth of the budget. The read-ahead buffer
+	// takes as much again, and for short records the row index, the matches
+	// and their sort keys take about three times as much.
+	constexpr std::size_t budgetPerChunk = 6;
+	constexpr std::size_t minimumChunk = 64 * 1024;
+
+	// Room for the text of a chunk and its row index, in chunks.
+	constexpr std::size_t arenaPerChunk = 3;
+
+	// More runs than this are first merged in groups, so the number of open
+	// files stays bounded however small the budget is.
+	constexpr std::size_t maxFanIn = 256;
+
+	// Splits CSV text into chunks of whole records, each preceded by the
+	// header line. Records end at line breaks outside quotes, so quoted
+	// cells with line breaks are never cut in two.
+	class ChunkReader
+	{
+	public:
+		ChunkReader(std::istream& input, std::size_t chunkBytes)
+			: input(input)
+			, chunkBytes(chunkBytes)
+		{
+			take(true, header);
+		}
+
+		// Sets `chunk` to the header and the next records, about `chunkBytes`
+		// of them. Returns false when there are no records left.
+		bool next(std::pmr::string& chunk)
+		{
+			chunk = header;
+			return take(false, chunk);
+		}
+
+		// Returns true once every record has been handed out.
+		bool done() const
+		{
+			return pending.empty() && !input;
+		}
+
+	private:
+		// Reads until `pending` holds `bytes` or the input ends.
+		void fill(std::size_t bytes)
+		{
+			while (input && pending.size() < bytes)
+			{
+				const std::size_t used = pending.size();
+				pending.resize(bytes);
+				input.read(pending.data() + used, static_cast<std::streamsize>(bytes - used));
+				pending.resize(used + static_cast<std::size_t>(input.gcount()));
+			}
+		}
+
+		// Position just past the first or the last record of `pending`, or
+		// `npos` if it doesn't hold a whole record yet. Quotes are read the
+		// way `EventTable` reads them: they only open a quoted cell at the
+		// start of a cell, and `""` inside one is an escaped quote. Quotes
+		// are rare, so the text between them is searched in bulk.
+		std::size_t recordEnd(bool first) const
+		{
+			const std::string_view text{ pending };
+			std::size_t end = std::string::npos;
+			for (std::size_t pos{ 0 }; pos < text.size(); )
+			{
+				// Up to the next quote that opens a cell, line breaks end records.
+				std::size_t quote = text.find('"', pos);
+				while (quote != std::string_view::npos && quote > 0 && text[quote - 1] != ',' && text[quote - 1] != '\n')
+				{
+					quote = text.find('"', quote + 1);
+				}
+				const std::string_view plain = text.substr(pos, quote == std::string_view::npos ? std::string_view::npos : quote - pos);
+				const std::size_t lineBreak = first ? plain.find('\n') : plain.rfind('\n');
+				if (lineBreak != std::string_view::npos)
+				{
+					end = pos + lineBreak + 1;
+					if (first)
+					{
+						break;
+					}
+				}
+				if (quote == std::string_view::npos)
+				{
+					break;
+				}
+
+				// Skip the quoted cell.
+				pos = quote + 1;
+				for (;;)
+				{
+					pos = text.find('"', pos);
+					if (pos == std::string_view::npos || pos + 1 == text.size())
+					{
+						return end; // the cell goes on past what has been read
+					}
+					if (text[pos + 1] != '"')
+					{
+						pos++;
+						break;
+					}
+					pos += 2;
+				}
+			}
+			return end;
+		}
+
+		// Moves the first record, or as many whole records as fit into a
+		// chunk, from the input to the end of `out`. A record longer than a
+		// chunk is taken whole. Returns false if there was nothing left.
+		bool take(bool first, std::pmr::string& out)
+		{
+			std::size_t wanted = chunkBytes;
+			for (;;)
+			{
+				fill(wanted);
+				std::size_t end = recordEnd(first);
+				if (!input && (end == std::string::npos || !first))
+				{
+					end = pending.size(); // the last record may lack a line break
+				}
+				if (end != std::string::npos)
+				{
+					out.reserve(out.size() + end);
+					out.append(pending, 0, end);
+					pending.erase(0, end);
+					return end > 0;
+				}
+				wanted = pending.size() * 2;
+			}
+		}
+
+		std::istream& input;
+		std::size_t chunkBytes;
+		std::pmr::string header;
+		std::string pending; // read but not handed out, starts at a record
+	};
+
+	// One matching event in a run file: the day serial, the lengths of the
+	// category and the description, and then their bytes.
+	struct RunRecord
+	{
+		std::int32_t day{ 0 };
+		std::string category;
+		std::string description;
+	};
+
+	void appendRecord(std::string& out, std::int32_t day, std::string_view category, std::string_view description)
+	{
+		const std::uint32_t lengths[2] = { static_cast<std::uint32_t>(category.size()), static_cast<std::uint32_t>(description.size()) };
+		out.append(reinterpret_cast<const char*>(&day), sizeof day);
+		out.append(reinterpret_cast<const char*>(lengths), sizeof lengths);
+		out += category;
+		out += description;
+	}
+
+	bool readRecord(std::istream& input, RunRecord& record)
+	{
+		char head[sizeof(std::int32_t) + 2 * sizeof(std::uint32_t)];
+		if (!input.read(head, sizeof head))
+		{
+			return false;
+		}
+		std::uint32_t lengths[2];
+		std::memcpy(&record.day, head, sizeof record.day);
+		std::memcpy(lengths, head + sizeof record.day, sizeof lengths);
+		record.category.resize(lengths[0]);
+		record.description.resize(lengths[1]);
+		return input.read(record.category.data(), lengths[0]) && input.read(record.description.data(), lengths[1]);
+	}
+
+	// Strict order of the sort keys of two records.
+	bool before(const RunRecord& a, const RunRecord& b, SortOrder order)
+	{
+		switch (order)
+		{
+		case SortOrder::Date:
+			return a.day < b.day;
+		case SortOrder::DateDescending:
+			return a.day > b.day;
+		case SortOrder::Category:
+			return a.category < b.category;
+		}
+		return false;
+	}
+
+	// Writes run records to a file in large blocks.
+	class RunWriter
+	{
+	public:
+		explicit RunWriter(const std::filesystem::path& path)
+			: path(path)
+			, file(path, std::ios::binary | std::ios::trunc)
+		{
+		}
+
+		void add(std::int32_t day, std::string_view category, std::string_view description)
+		{
+			appendRecord(block, day, category, description);
+			if (block.size() >= blockSize)
+			{
+				flush();
+			}
+		}
+
+		bool close()
+		{
+			flush();
+			file.close();
+			if (!file)
+			{
+				std::cerr << "Unable to write " << path.string() << '\n';
+				return false;
+			}
+			return true;
+		}
+
+	private:
+		static constexpr std::size_t blockSize = 1 << 20;
+
+		void flush()
+		{
+			file.write(block.data(), static_cast<std::streamsize>(block.size()));
+			block.clear();
+		}
+
+		std::filesystem::path path;
+		std::ofstream file;
+		std::string block;
+	};
+
+	// Sorted runs next to the events file. The files are removed when the
+	// object goes away, also after an error.
+	class Runs
+	{
+	public:
+		explicit Runs(const std::filesystem::path& eventsPath)
+			: base(eventsPath)
+		{
+		}
+
+		~Runs()
+		{
+			if (!directory.empty())
+			{
+				std::error_code error;
+				std::filesystem::remove_all(directory, error);
+			}
+		}
+
+		bool empty() const
+		{
+			return paths.empty();
+		}
+
+		// Writes `rows` of `table` as the next run.
+		bool write(const EventTable& table, const std::vector<std::size_t>& rows)
+		{
+			if (directory.empty() && !makeDirectory())
+			{
+				return false;
+			}
+			RunWriter run(nextPath());
+			for (std::size_t row : rows)
+			{
+				const auto day = std::chrono::sys_days{ table.date(row).value() }.time_since_epoch().count();
+				run.add(static_cast<std::int32_t>(day), table.category(row), table.description(row));
+			}
+			return run.close();
+		}
+
+		// Merges all runs in the order of `order` and calls `emit` for every
+		// record. Runs are numbered in file order and ties go to the lower
+		// run, so the result is stable.
+		bool merge(SortOrder order, const std::function<void(const RunRecord&)>& emit)
+		{
+			while (paths.size() > maxFanIn)
+			{
+				const std::size_t merged = paths.size();
+				for (std::size_t first{ 0 }; first < merged; first += maxFanIn)
+				{
+					RunWriter run(nextPath());
+					const bool good = mergeRange(first, std::min(merged, first + maxFanIn), order, [&](const RunRecord& record)
+						{
+							run.add(record.day, record.category, record.description);
+						});
+					if (!run.close() || !good)
+					{
+						return false;
+					}
+				}
+				for (std::size_t i{ 0 }; i < merged; i++)
+				{
+					std::error_code error;
+					std::filesystem::remove(paths[i], error);
+				}
+				paths.erase(paths.begin(), paths.begin() + static_cast<std::ptrdiff_t>(merged));
+			}
+			return mergeRange(0, paths.size(), order, emit);
+		}
+
+	private:
+		// Run files go into a directory of their own next to the events file,
+		// so commands sorting the same file at the same time don't share runs.
+		bool makeDirectory()
+		{
+			std::random_device random;
+			for (int attempt{ 0 }; attempt < 100; attempt++)
+			{
+				std::filesystem::path candidate = base;
+				candidate += ".runs-" + std::to_string(random()) + std::to_string(random());
+				std::error_code error;
+				if (std::filesystem::create_directory(candidate, error))
+				{
+					directory = candidate;
+					return true;
+				}
+				if (error)
+				{
+					break;
+				}
+			}
+			std::cerr << "Unable to create a directory for sorting next to " << base.string() << '\n';
+			return false;
+		}
+
+		std::filesystem::path nextPath()
+		{
+			std::filesystem::path path = directory / ("run" + std::to_string(next++));
+			paths.push_back(path);
+			return path;
+		}
+
+		bool mergeRange(std::size_t first, std::size_t last, SortOrder order,
+			const std::function<void(const RunRecord&)>& emit) const
+		{
+			std::vector<std::ifstream> files;
+			files.reserve(last - first);
+			std::vector<RunRecord> heads(last - first);
+			auto later = [&](std::size_t a, std::size_t b)
+				{
+					return before(heads[b], heads[a], order) || (!before(heads[a], heads[b], order) && b < a);
+				};
+			std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> queue(later);
+			for (std::size_t run{ first }; run < last; run++)
+			{
+				files.emplace_back(paths[run], std::ios::binary);
+				if (!files.back())
+				{
+					std::cerr << "Unable to read " << paths[run].string() << '\n';
+					return false;
+				}
+				if (readRecord(files.back(), heads[run - first]))
+				{
+					queue.push(run - first);
+				}
+			}
+
+			while (!queue.empty())
+			{
+				const std::size_t run = queue.top();
+				queue.pop();
+				emit(heads[run]);
+				if (readRecord(files[run], heads[run]))
+				{
+					queue.push(run);
+				}
+			}
+			return true;
+		}
+
+		std::filesystem::path base;
+		std::filesystem::path directory;
+		std::vector<std::filesystem::path> paths;
+		std::size_t next{ 0 };
+	};
+
+	Event toEvent(const RunRecord& record)
+	{
+		const std::chrono::sys_days day{ std::chrono::days{ record.day } };
+		return Event{ std::chrono::year_month_day{ day }, record.category, record.description };
+	}
+}
+
+std::optional<std::size_t> parseMemoryBudget(std::string_view text)
+{
+	std::size_t value = 0;
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (error != std::errc{} || end == text.data())
+	{
+		return std::nullopt;
+	}
+
+	const std::string_view suffix{ end, static_cast<std::size_t>(text.data() + text.size() - end) };
+	int shift = 0;
+	if (suffix == "K" || suffix == "k")
+		shift = 10;
+	else if (suffix == "M" || suffix == "m")
+		shift = 20;
+	else if (suffix == "G" || suffix == "g")
+		shift = 30;
+	else if (!suffix.empty())
+		return std::nullopt;
+
+	if (value == 0 || value > (SIZE_MAX >> shift))
+	{
+		return std::nullopt;
+	}
+	return value << shift;
+}
+
+std::optional<std::size_t> listExternally(const std::filesystem::path& eventsPath, const Query& query,
+	std::optional<SortOrder> order, std::size_t memoryBudget, std::chrono::sys_days today,
+	const std::function<void(const Event&)>& emit)
+{
+	std::ifstream file(eventsPath, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Unable to read " << eventsPath.string() << '\n';
+		return std::nullopt;
+	}
+
+	const std::size_t chunkBytes = std::max(memoryBudget / budgetPerChunk, minimumChunk);
+	ChunkReader reader(file, chunkBytes);
+	Runs runs(eventsPath);
+	std::size_t count = 0;
+	std::size_t firstRow = 0;
+
+	// The text and the table of every chunk are allocated from one block,
+	// which is reset for the next chunk instead of freeing them piece by
+	// piece. Chunks that need more spill over to the heap.
+	const std::size_t arenaBytes = arenaPerChunk * chunkBytes;
+	const std::unique_ptr<std::byte[]> block(new std::byte[arenaBytes]);
+	std::pmr::monotonic_buffer_resource arena(block.get(), arenaBytes);
+	for (;; arena.release())
+	{
+		std::pmr::string chunk{ &arena };
+		if (!reader.next(chunk))
+		{
+			break;
+		}
+		EventTable table(&arena);
+		if (!table.load(std::move(chunk), firstRow))
+		{
+			std::cerr << "Unable to read " << eventsPath.string() << '\n';
+			return std::nullopt;
+		}
+		firstRow += table.size();
+
+		auto rows = query.execute(table, today);
+		count += rows.size();
+		if (order.has_value())
+		{
+			sortRows(table, rows, order.value());
+		}
+
+		// Unsorted output, and sorted output of a file that fits into one
+		// chunk, need no run files.
+		if (!order.has_value() || (runs.empty() && reader.done()))
+		{
+			for (std::size_t row : rows)
+			{
+				emit(table.event(row));
+			}
+			continue;
+		}
+		if (!rows.empty() && !runs.write(table, rows))
+		{
+			return std::nullopt;
+		}
+	}
+
+	if (order.has_value() && !runs.empty())
+	{
+		if (!runs.merge(order.value(), [&](const RunRecord& record) { emit(toEvent(record)); }))
+		{
+			return std::nullopt;
+		}
+	}
+	return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+#include "Event.h"
+#include "Query.h"
+#include "Sort.h"
+
+// `days list` without loading the events file: a plain `list` streams it,
+// and `list ... --memory-budget SIZE` sorts files larger than memory.
+//
+// The file is never loaded as a whole. It is read in chunks of complete
+// records, each indexed as its own `EventTable` and filtered with the query.
+// Without a sort order the matches are passed on chunk by chunk. With one,
+// the sorted matches of every chunk are written to a run file in a
+// directory of its own next to the events file, and the runs are merged k
+// ways while the events are passed on, so memory holds one chunk, or one
+// buffered record per run.
+
+// Memory budget of a plain `days list`, which needs no state across events
+// and so streams any file in chunks of this order of size.
+constexpr std::size_t streamingBudget = std::size_t{ 8 } << 20;
+
+// Parses a memory budget such as `1G`, `512M`, `64K` or a plain number of
+// bytes. The suffixes are powers of 1024.
+std::optional<std::size_t> parseMemoryBudget(std::string_view text);
+
+// Calls `emit` for every event of the events file at `eventsPath` that
+// passes `query`, in file order or sorted by `order`, using about
+// `memoryBudget` bytes. Events with equal sort keys stay in file order.
+// Returns the number of events, or `std::nullopt` if a file couldn't be
+// read or written; the problem is reported on standard error.
+std::optional<std::size_t> listExternally(const std::filesystem::path& eventsPath, const Query& query,
+	std::optional<SortOrder> order, std::size_t memoryBudget, std::chrono::sys_days today,
+	const std::function<void(const Event&)>& emit);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+// Size and modification time of a file. The index files stored next to the
+// events file record the stamp of the file they were built from, and are
+// only used while it still matches.
+struct FileStamp
+{
+	std::uint64_t size{ 0 };
+	std::int64_t time{ 0 };
+
+	bool operator==(const FileStamp&) const = default;
+
+	static FileStamp of(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		FileStamp stamp;
+		stamp.size = std::filesystem::file_size(path, error);
+		stamp.time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		return stamp;
+	}
+};
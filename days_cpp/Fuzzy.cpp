@@ -0,0 +1,118 @@
+#include "Fuzzy.h"
+
+#include <algorithm> // for std::min and sorting
+#include <chrono>	 // for ordering by date
+#include <tuple>	 // for std::tie
+
+#include "Parallel.h"
+
+FuzzyMatcher::FuzzyMatcher(std::string_view text)
+	: pattern(text)
+{
+	if (pattern.size() <= 64)
+	{
+		for (std::size_t i{ 0 }; i < pattern.size(); i++)
+		{
+			peq[static_cast<unsigned char>(pattern[i])] |= std::uint64_t{ 1 } << i;
+		}
+	}
+}
+
+int FuzzyMatcher::distance(std::string_view text) const
+{
+	const int m = static_cast<int>(pattern.size());
+	if (m == 0)
+	{
+		return 0;
+	}
+	if (m > 64)
+	{
+		return distanceLong(text);
+	}
+
+	// Pv/Mv hold the positive and negative vertical deltas of the current
+	// column, `score` the value in its last row. Leaving the shifted-in bit
+	// of the horizontal deltas at zero lets a match start anywhere in the text.
+	const std::uint64_t last = std::uint64_t{ 1 } << (m - 1);
+	std::uint64_t pv = ~std::uint64_t{ 0 };
+	std::uint64_t mv = 0;
+	int score = m;
+	int best = m;
+	for (char c : text)
+	{
+		const std::uint64_t eq = peq[static_cast<unsigned char>(c)];
+		const std::uint64_t xv = eq | mv;
+		const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+		std::uint64_t ph = mv | ~(xh | pv);
+		std::uint64_t mh = pv & xh;
+		if (ph & last)
+		{
+			score++;
+		}
+		else if (mh & last)
+		{
+			score--;
+		}
+		ph <<= 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+		best = std::min(best, score);
+	}
+	return best;
+}
+
+int FuzzyMatcher::distanceLong(std::string_view text) const
+{
+	// column[i] is the distance between pattern[0, i) and the best substring
+	// of the text ending at the current position.
+	std::vector<int> column(pattern.size() + 1);
+	for (std::size_t i{ 0 }; i < column.size(); i++)
+	{
+		column[i] = static_cast<int>(i);
+	}
+	int best = column.back();
+	for (char c : text)
+	{
+		int diagonal = 0; // the first row is free: a match may start anywhere
+		for (std::size_t i{ 1 }; i < column.size(); i++)
+		{
+			const int above = column[i];
+			column[i] = std::min({ above + 1, column[i - 1] + 1, diagonal + (pattern[i - 1] == c ? 0 : 1) });
+			diagonal = above;
+		}
+		best = std::min(best, column.back());
+	}
+	return best;
+}
+
+std::vector<std::size_t> fuzzySearch(const EventTable& table, std::string_view term, int maxDistance)
+{
+	const FuzzyMatcher matcher(term);
+	std::vector<int> distances(table.size());
+	parallelFor(table.size(), 8192, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t row{ begin }; row < end; row++)
+			{
+				distances[row] = matcher.distance(table.description(row));
+			}
+		});
+
+	// Dates are only parsed for the matches, here on one thread, so the
+	// messages about bad dates come out in row order.
+	std::vector<std::size_t> matches;
+	for (std::size_t row{ 0 }; row < table.size(); row++)
+	{
+		if (distances[row] <= maxDistance && !table.erased(row) && table.date(row).has_value())
+		{
+			matches.push_back(row);
+		}
+	}
+	std::sort(matches.begin(), matches.end(), [&](std::size_t a, std::size_t b)
+		{
+			const auto dateA = std::chrono::sys_days{ table.date(a).value() };
+			const auto dateB = std::chrono::sys_days{ table.date(b).value() };
+			return std::tie(distances[a], dateA, a) < std::tie(distances[b], dateB, b);
+		});
+	return matches;
+}
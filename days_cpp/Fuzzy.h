@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EventTable.h"
+
+// Approximate substring matcher for one pattern.
+//
+// `distance()` returns the smallest number of single character insertions,
+// deletions and substitutions that turn the pattern into some substring of
+// the text. Patterns of up to 64 bytes use Myers' bit-parallel algorithm,
+// which keeps a whole column of the edit distance matrix in two machine
+// words and advances it with a handful of bit operations per text byte.
+// Longer patterns fall back to the plain dynamic programming recurrence.
+class FuzzyMatcher
+{
+public:
+	explicit FuzzyMatcher(std::string_view pattern);
+
+	int distance(std::string_view text) const;
+
+private:
+	int distanceLong(std::string_view text) const;
+
+	std::string pattern;
+	std::array<std::uint64_t, 256> peq{}; // bit i set where pattern[i] is the byte
+};
+
+// Rows of `table` whose description contains `term` with at most
+// `maxDistance` edits, best matches first and equal ones ordered by date.
+// The descriptions are scanned on all cores.
+std::vector<std::size_t> fuzzySearch(const EventTable& table, std::string_view term, int maxDistance);
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// Fast non-cryptographic hash of `bytes`, eight bytes at a time.
+// Chaining calls through `seed` hashes a tuple of fields; the length of each
+// field is mixed in, so ("ab", "c") and ("a", "bc") hash differently.
+inline std::uint64_t hashBytes(std::string_view bytes, std::uint64_t seed = 0)
+{
+	constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+	auto mix = [](std::uint64_t x)
+	{
+		x ^= x >> 32;
+		x *= 0xD6E8FEB86659FD93ull;
+		x ^= x >> 32;
+		return x;
+	};
+
+	std::uint64_t hash = mix(seed ^ (bytes.size() * multiplier));
+	std::size_t i = 0;
+	for (; i + 8 <= bytes.size(); i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, bytes.data() + i, 8);
+		hash = mix(hash ^ word) * multiplier;
+	}
+	if (i < bytes.size())
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+		hash = mix(hash ^ word) * multiplier;
+	}
+	return mix(hash);
+}
+
+// Open-addressing hash index over items identified by 32-bit numbers, such
+// as row numbers. The index stores no keys itself: each slot holds an item
+// number and 32 bits of its hash, and callers compare the actual keys through
+// the `equal` callback. That keeps it at 8 bytes per slot, and with linear
+// probing a lookup is usually a single cache line.
+//
+// The capacity is fixed up front for `expected` items; inserting more throws
+// `std::length_error`.
+class HashIndex
+{
+public:
+	explicit HashIndex(std::size_t expected)
+		: slots(std::bit_ceil(std::max<std::size_t>(expected * 2, 16)))
+		, mask(slots.size() - 1)
+	{
+	}
+
+	// Looks for an item with the same key as `item`, using `equal(other)` to
+	// compare keys of items whose hashes match. Returns that item if found;
+	// otherwise records `item` and returns `std::nullopt`.
+	template <typename Equal>
+	std::optional<std::uint32_t> insert(std::uint32_t item, std::uint64_t hash, Equal&& equal)
+	{
+		const std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+		for (std::size_t i = hash & mask; ; i = (i + 1) & mask)
+		{
+			Slot& slot = slots[i];
+			if (slot.item == empty)
+			{
+				if (++count * 2 > slots.size() + slots.size() / 2)
+				{
+					throw std::length_error("HashIndex is full");
+				}
+				slot = Slot{ item, tag };
+				return std::nullopt;
+			}
+			if (slot.tag == tag && equal(slot.item))
+			{
+				return slot.item;
+			}
+		}
+	}
+
+private:
+	static constexpr std::uint32_t empty = 0xFFFFFFFFu;
+
+	struct Slot
+	{
+		std::uint32_t item{ empty };
+		std::uint32_t tag{ 0 };
+	};
+
+	std::vector<Slot> slots;
+	std::size_t mask;
+	std::size_t count{ 0 };
+};
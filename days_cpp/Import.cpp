@@ -0,0 +1,483 @@
+#include "Import.h"
+
+#include <chrono>		 // for timing the import
+#include <cstdint>		 // for fixed width integers
+#include <fstream>		 // for reading and appending files
+#include <iostream>		 // for standard I/O streams
+#include <iterator>		 // for std::istreambuf_iterator
+#include <memory>		 // for std::unique_ptr
+#include <optional>		 // for std::optional
+#include <string_view>	 // for std::string_view
+#include <unordered_map> // for interning categories
+
+#include "DescriptionIndex.h"
+#include "EventTable.h"
+#include "HashIndex.h"
+#include "Parallel.h"
+#include "TrigramIndex.h"
+#include "Utilities.h"
+
+namespace
+{
+	// One input record. The views point into the buffer the input was read into.
+	struct Record
+	{
+		std::string_view date;
+		std::string_view category;
+		std::string_view description;
+		bool wellFormed{ true };
+	};
+
+	// Appends `code` to `buf` at `out` as UTF-8 and advances `out`.
+	void putUtf8(std::string& buf, std::size_t& out, std::uint32_t code)
+	{
+		if (code < 0x80)
+		{
+			buf[out++] = static_cast<char>(code);
+		}
+		else if (code < 0x800)
+		{
+			buf[out++] = static_cast<char>(0xC0 | (code >> 6));
+			buf[out++] = static_cast<char>(0x80 | (code & 0x3F));
+		}
+		else if (code < 0x10000)
+		{
+			buf[out++] = static_cast<char>(0xE0 | (code >> 12));
+			buf[out++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+			buf[out++] = static_cast<char>(0x80 | (code & 0x3F));
+		}
+		else
+		{
+			buf[out++] = static_cast<char>(0xF0 | (code >> 18));
+			buf[out++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+			buf[out++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+			buf[out++] = static_cast<char>(0x80 | (code & 0x3F));
+		}
+	}
+
+	std::optional<std::uint32_t> readHex4(const std::string& buf, std::size_t pos, std::size_t end)
+	{
+		if (pos + 4 > end)
+		{
+			return std::nullopt;
+		}
+		std::uint32_t value = 0;
+		for (std::size_t i{ pos }; i < pos + 4; i++)
+		{
+			const char c = buf[i];
+			value <<= 4;
+			if (c >= '0' && c <= '9')
+				value |= static_cast<std::uint32_t>(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				value |= static_cast<std::uint32_t>(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				value |= static_cast<std::uint32_t>(c - 'A' + 10);
+			else
+				return std::nullopt;
+		}
+		return value;
+	}
+
+	// Reads a JSON string starting at the opening quote at `pos` and decodes
+	// its escapes in place; the decoded text is never longer than the escaped one.
+	bool readJsonString(std::string& buf, std::size_t& pos, std::size_t end, std::string_view& value)
+	{
+		if (pos >= end || buf[pos] != '"')
+		{
+			return false;
+		}
+		const std::size_t start = pos;
+		std::size_t out = start;
+		pos++;
+		while (pos < end)
+		{
+			const char c = buf[pos++];
+			if (c == '"')
+			{
+				value = std::string_view{ buf.data() + start, out - start };
+				return true;
+			}
+			if (c != '\\')
+			{
+				buf[out++] = c;
+				continue;
+			}
+			if (pos >= end)
+			{
+				return false;
+			}
+			const char escape = buf[pos++];
+			switch (escape)
+			{
+			case '"': buf[out++] = '"'; break;
+			case '\\': buf[out++] = '\\'; break;
+			case '/': buf[out++] = '/'; break;
+			case 'b': buf[out++] = '\b'; break;
+			case 'f': buf[out++] = '\f'; break;
+			case 'n': buf[out++] = '\n'; break;
+			case 'r': buf[out++] = '\r'; break;
+			case 't': buf[out++] = '\t'; break;
+			case 'u':
+			{
+				auto code = readHex4(buf, pos, end);
+				if (!code.has_value())
+				{
+					return false;
+				}
+				pos += 4;
+				std::uint32_t codePoint = code.value();
+				// A high surrogate must be followed by an escaped low surrogate.
+				if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+				{
+					if (pos + 1 >= end || buf[pos] != '\\' || buf[pos + 1] != 'u')
+					{
+						return false;
+					}
+					auto low = readHex4(buf, pos + 2, end);
+					if (!low.has_value() || low.value() < 0xDC00 || low.value() > 0xDFFF)
+					{
+						return false;
+					}
+					pos += 6;
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low.value() - 0xDC00);
+				}
+				putUtf8(buf, out, codePoint);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return false;
+	}
+
+	void skipSpace(const std::string& buf, std::size_t& pos, std::size_t end)
+	{
+		while (pos < end && (buf[pos] == ' ' || buf[pos] == '\t' || buf[pos] == '\r'))
+		{
+			pos++;
+		}
+	}
+
+	// Parses one NDJSON line of the form
+	// {"date": "2024-01-01", "category": "work", "description": "..."}.
+	// `category` and `description` may be missing or null; other keys are ignored
+	// as long as their values are strings or null.
+	Record parseJsonLine(std::string& buf, std::size_t pos, std::size_t end)
+	{
+		Record record;
+		record.wellFormed = false;
+
+		skipSpace(buf, pos, end);
+		if (pos >= end || buf[pos++] != '{')
+		{
+			return record;
+		}
+		skipSpace(buf, pos, end);
+		if (pos < end && buf[pos] == '}')
+		{
+			return record;
+		}
+
+		while (true)
+		{
+			std::string_view key;
+			std::string_view value;
+			skipSpace(buf, pos, end);
+			if (!readJsonString(buf, pos, end, key))
+			{
+				return record;
+			}
+			skipSpace(buf, pos, end);
+			if (pos >= end || buf[pos++] != ':')
+			{
+				return record;
+			}
+			skipSpace(buf, pos, end);
+			if (buf.compare(pos, 4, "null") == 0)
+			{
+				pos += 4;
+			}
+			else if (!readJsonString(buf, pos, end, value))
+			{
+				return record;
+			}
+
+			if (key == "date")
+				record.date = value;
+			else if (key == "category")
+				record.category = value;
+			else if (key == "description")
+				record.description = value;
+
+			skipSpace(buf, pos, end);
+			if (pos < end && buf[pos] == ',')
+			{
+				pos++;
+				continue;
+			}
+			if (pos < end && buf[pos] == '}')
+			{
+				record.wellFormed = true;
+				return record;
+			}
+			return record;
+		}
+	}
+
+	// Key of an event for exact duplicate detection. The category is
+	// compared by its interned id.
+	struct EventKey
+	{
+		std::int32_t day;
+		std::uint32_t category;
+		std::string_view description;
+
+		bool operator==(const EventKey&) const = default;
+
+		std::uint64_t hash() const
+		{
+			return hashBytes(description, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(day)) << 32) | category);
+		}
+	};
+
+	std::int32_t dayNumber(const std::chrono::year_month_day& date)
+	{
+		return std::chrono::sys_days{ date }.time_since_epoch().count();
+	}
+}
+
+bool parseImportOptions(const std::vector<std::string>& args, ImportOptions& options, std::string& error)
+{
+	for (std::size_t i{ 0 }; i < args.size(); i++)
+	{
+		if (args[i] == "--format")
+		{
+			if (i + 1 >= args.size() || (args[i + 1] != "csv" && args[i + 1] != "ndjson"))
+			{
+				error = "--format must be csv or ndjson";
+				return false;
+			}
+			options.format = args[++i];
+		}
+		else if (args[i] == "--dedupe")
+		{
+			options.dedupe = true;
+		}
+		else if (options.file.empty() && !args[i].starts_with("--"))
+		{
+			options.file = args[i];
+		}
+		else
+		{
+			error = "unknown import option: " + args[i];
+			return false;
+		}
+	}
+	return true;
+}
+
+int importEvents(const ImportOptions& options, const std::filesystem::path& eventsPath)
+{
+	const auto started = std::chrono::steady_clock::now();
+
+	std::ifstream file;
+	if (!options.file.empty())
+	{
+		file.open(options.file, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Unable to read " << options.file << '\n';
+			return 1;
+		}
+	}
+	std::istream& input = options.file.empty() ? std::cin : file;
+
+	// Collect the records. CSV input goes through the same indexer as the
+	// events file; NDJSON is decoded in place, one line per record.
+	EventTable csv;
+	std::string json;
+	std::vector<Record> records;
+	if (options.format == "csv")
+	{
+		if (!csv.load(input))
+		{
+			return 1;
+		}
+		records.reserve(csv.size());
+		for (std::size_t row{ 0 }; row < csv.size(); row++)
+		{
+			records.push_back(Record{ csv.dateText(row), csv.category(row), csv.description(row) });
+		}
+	}
+	else
+	{
+		json.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+		std::size_t pos = 0;
+		while (pos < json.size())
+		{
+			std::size_t end = json.find('\n', pos);
+			if (end == std::string::npos)
+			{
+				end = json.size();
+			}
+			std::size_t first = pos;
+			skipSpace(json, first, end);
+			if (first < end)
+			{
+				records.push_back(parseJsonLine(json, pos, end));
+			}
+			pos = end + 1;
+		}
+	}
+
+	// Validate the dates on all cores.
+	std::vector<std::optional<std::chrono::year_month_day>> dates(records.size());
+	parallelFor(records.size(), 16384, [&](std::size_t begin, std::size_t end)
+		{
+			Utilities tools;
+			for (std::size_t i{ begin }; i < end; i++)
+			{
+				if (records[i].wellFormed)
+				{
+					dates[i] = tools.parseIsoDate(records[i].date);
+				}
+			}
+		});
+
+	// Intern the categories so each distinct name is stored and compared once.
+	std::unordered_map<std::string_view, std::uint32_t> categoryIds;
+	auto intern = [&](std::string_view name)
+	{
+		return categoryIds.try_emplace(name, static_cast<std::uint32_t>(categoryIds.size())).first->second;
+	};
+
+	// With --dedupe, events already in the store count as seen.
+	EventTable existing;
+	std::vector<EventKey> keys;
+	std::unique_ptr<HashIndex> seen;
+	// Returns true if `key` was not seen before and remembers it.
+	auto firstSeen = [&](const EventKey& key)
+	{
+		keys.push_back(key);
+		auto same = [&](std::uint32_t other) { return keys[other] == key; };
+		if (seen->insert(static_cast<std::uint32_t>(keys.size() - 1), key.hash(), same).has_value())
+		{
+			keys.pop_back();
+			return false;
+		}
+		return true;
+	};
+	if (options.dedupe)
+	{
+		seen = std::make_unique<HashIndex>(records.size() + 1);
+	}
+	if (options.dedupe && std::filesystem::exists(eventsPath))
+	{
+		if (!existing.load(eventsPath))
+		{
+			std::cerr << "Unable to read " << eventsPath.string() << '\n';
+			return 1;
+		}
+		seen = std::make_unique<HashIndex>(existing.size() + records.size());
+		for (std::size_t row{ 0 }; row < existing.size(); row++)
+		{
+			auto date = existing.date(row);
+			if (date.has_value())
+			{
+				firstSeen(EventKey{ dayNumber(date.value()), intern(existing.category(row)), existing.description(row) });
+			}
+		}
+	}
+
+	std::string out;
+	std::size_t accepted = 0;
+	std::size_t rejected = 0;
+	std::size_t duplicates = 0;
+	constexpr std::size_t maxReported = 10;
+	for (std::size_t i{ 0 }; i < records.size(); i++)
+	{
+		const Record& record = records[i];
+		if (!dates[i].has_value())
+		{
+			if (rejected < maxReported)
+			{
+				if (!record.wellFormed)
+					std::cerr << "rejected record " << i + 1 << ": malformed line\n";
+				else
+					std::cerr << "rejected record " << i + 1 << ": bad date " << record.date << '\n';
+			}
+			rejected++;
+			continue;
+		}
+
+		const std::uint32_t category = intern(record.category);
+		if (options.dedupe && !firstSeen(EventKey{ dayNumber(dates[i].value()), category, record.description }))
+		{
+			duplicates++;
+			continue;
+		}
+
+		appendCsvRow(out, record.date, record.category, record.description);
+		accepted++;
+	}
+	if (rejected > maxReported)
+	{
+		std::cerr << "... and " << rejected - maxReported << " more rejected records\n";
+	}
+
+	// Append everything with one write. Start a new file with a header, and
+	// make sure an existing one ends with a line break first.
+	if (!out.empty())
+	{
+		std::string prefix;
+		std::ifstream current(eventsPath, std::ios::binary | std::ios::ate);
+		if (!current || current.tellg() == 0)
+		{
+			prefix = "date,category,description\n";
+		}
+		else
+		{
+			current.seekg(-1, std::ios::end);
+			if (current.get() != '\n')
+			{
+				prefix = "\n";
+			}
+		}
+		current.close();
+
+		const bool indexCurrent = TrigramIndex::isCurrent(eventsPath);
+		const bool descriptionsCurrent = DescriptionIndex::isCurrent(eventsPath);
+		std::ofstream events(eventsPath, std::ios::binary | std::ios::app);
+		events.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+		events.write(out.data(), static_cast<std::streamsize>(out.size()));
+		events.close();
+		if (!events)
+		{
+			std::cerr << "An error occured while writing to file." << '\n';
+			return 1;
+		}
+		if (indexCurrent)
+		{
+			TrigramIndex::restamp(eventsPath);
+		}
+		if (descriptionsCurrent)
+		{
+			DescriptionIndex::restamp(eventsPath);
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+	std::cout << "Imported " << accepted << " events, rejected " << rejected;
+	if (options.dedupe)
+	{
+		std::cout << ", skipped " << duplicates << " duplicates";
+	}
+	std::cout << " (" << categoryIds.size() << " categories) in " << elapsed.count() << " s";
+	if (elapsed.count() > 0)
+	{
+		std::cout << ", " << static_cast<std::size_t>(records.size() / elapsed.count()) << " records/s";
+	}
+	std::cout << std::endl;
+	return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Options of `days import [--format csv|ndjson] [--dedupe] [FILE]`.
+struct ImportOptions
+{
+	std::string format{ "csv" };
+	bool dedupe{ false };
+	std::string file; // empty means standard input
+};
+
+// Parses the words following `import`. On failure returns false and
+// describes the problem in `error`.
+bool parseImportOptions(const std::vector<std::string>& args, ImportOptions& options, std::string& error);
+
+// Validates the events read from `options.file` (or standard input) and
+// appends the accepted ones to the events file at `eventsPath` in one write.
+// Prints accepted and rejected counts and the throughput.
+// Returns the exit code for `main()`.
+int importEvents(const ImportOptions& options, const std::filesystem::path& eventsPath);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Splits the index range [0, count) into one contiguous chunk per hardware
+// thread and calls `work(begin, end)` for each chunk, then waits for all of
+// them. Inputs with fewer than `minimumPerThread` items per thread use fewer
+// threads, down to running `work(0, count)` directly on the calling thread,
+// so small calendars never pay for starting threads.
+template <typename Work>
+void parallelFor(std::size_t count, std::size_t minimumPerThread, Work work)
+{
+	const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+	const std::size_t threads = std::clamp<std::size_t>(count / std::max<std::size_t>(minimumPerThread, 1), 1, hardware);
+	if (threads == 1)
+	{
+		work(std::size_t{ 0 }, count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	const std::size_t chunk = (count + threads - 1) / threads;
+	for (std::size_t t{ 1 }; t < threads; t++)
+	{
+		const std::size_t begin = std::min(count, t * chunk);
+		const std::size_t end = std::min(count, begin + chunk);
+		workers.emplace_back([&work, begin, end] { work(begin, end); });
+	}
+	work(std::size_t{ 0 }, std::min(count, chunk));
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
@@ -0,0 +1,686 @@
+#include "Query.h"
+
+#include <algorithm> // for std::find and ordering the plan
+#include <iostream>	 // for the messages of a parallel scan
+#include <limits>	 // for the day serial bounds
+#include <memory>	 // for smart pointers
+#include <mutex>	 // for collecting the chunks of a parallel scan
+#include <sstream>	 // for splitting lines into words
+
+#include "DescriptionIndex.h"
+#include "Parallel.h"
+#include "RoaringBitmap.h"
+#include "ScanKernels.h"
+#include "Simd.h"
+#include "Utilities.h"
+
+std::vector<std::string> splitWords(const std::string& line)
+{
+	std::vector<std::string> words;
+	std::string word;
+	bool inWord = false;
+	bool quoted = false;
+	for (char c : line)
+	{
+		if (c == '"')
+		{
+			quoted = !quoted;
+			inWord = true;
+		}
+		else if (!quoted && (c == ' ' || c == '\t' || c == '\r'))
+		{
+			if (inWord)
+			{
+				words.push_back(word);
+				word.clear();
+				inWord = false;
+			}
+		}
+		else
+		{
+			word += c;
+			inWord = true;
+		}
+	}
+	if (inWord)
+	{
+		words.push_back(word);
+	}
+	return words;
+}
+
+std::vector<std::string> splitCommas(const std::string& text)
+{
+	std::vector<std::string> parts;
+	std::istringstream input(text);
+	std::string part;
+	while (std::getline(input, part, ','))
+	{
+		parts.push_back(part);
+	}
+	if (text.empty() || text.back() == ',')
+	{
+		parts.push_back("");
+	}
+	return parts;
+}
+
+namespace
+{
+	using Predicate = Query::Predicate;
+	using Kind = Query::Predicate::Kind;
+
+	bool parseDate(const std::vector<std::string>& args, std::size_t index,
+		std::chrono::year_month_day& date, std::string& error)
+	{
+		if (index >= args.size())
+		{
+			error = "No date given";
+			return false;
+		}
+		Utilities tools;
+		auto parsed = tools.getDateFromString(args[index]);
+		if (!parsed.has_value())
+		{
+			error = "bad date: " + args[index];
+			return false;
+		}
+		date = parsed.value();
+		return true;
+	}
+
+	// Planner cost of a predicate, lowest first. Category and description
+	// tests compare a field with a constant; date tests parse the date field
+	// first, and equalities are more selective than ranges; a regular
+	// expression has to look at both text fields.
+	int rank(const Predicate& predicate)
+	{
+		switch (predicate.kind)
+		{
+		case Kind::NoCategory:
+			return 0;
+		case Kind::Categories:
+			return 1;
+		case Kind::DescriptionPrefix:
+			return 2;
+		case Kind::OnDate:
+		case Kind::Today:
+			return 3;
+		case Kind::Between:
+			return 4;
+		case Kind::Before:
+		case Kind::After:
+			return 5;
+		case Kind::Match:
+			return 6;
+		case Kind::Not:
+			return rank(predicate.operand.front());
+		}
+		return 0;
+	}
+
+	bool test(const Predicate& predicate, const EventTable& table, std::size_t row, std::chrono::sys_days today)
+	{
+		switch (predicate.kind)
+		{
+		case Kind::NoCategory:
+			return table.category(row).empty();
+		case Kind::Categories:
+			return std::find(predicate.categories.begin(), predicate.categories.end(), table.category(row)) != predicate.categories.end();
+		case Kind::DescriptionPrefix:
+			return table.description(row).starts_with(predicate.text);
+		case Kind::Match:
+			return predicate.regex->search(table.description(row)) || predicate.regex->search(table.category(row));
+		case Kind::Not:
+			return !test(predicate.operand.front(), table, row, today);
+		default:
+			break;
+		}
+
+		const auto date = table.date(row);
+		if (!date.has_value())
+		{
+			return false;
+		}
+		switch (predicate.kind)
+		{
+		case Kind::Today:
+			return std::chrono::sys_days{ date.value() } == today;
+		case Kind::Before:
+			return date.value() < predicate.date1;
+		case Kind::After:
+			return date.value() > predicate.date1;
+		case Kind::OnDate:
+			return date.value() == predicate.date1;
+		case Kind::Between:
+			return date.value() >= predicate.date1 && date.value() <= predicate.date2;
+		default:
+			return true;
+		}
+	}
+
+	// Tables with fewer rows than this per thread are scanned on fewer
+	// threads, and small calendars on the calling thread only.
+	constexpr std::size_t parallelRowsPerThread = 1 << 16;
+
+	// Queries with up to this many predicates get a specialized scan loop;
+	// longer ones use the generic loop of `passes()`.
+	constexpr std::size_t maxKernelTests = 2;
+
+	// Turns the predicates [rest, end) into kernel tests one at a time, so
+	// the types of the tests are fixed at compile time, and finally calls
+	// `run(tests...)`. Returns false without calling `run` if there are too
+	// many predicates or one of them has no kernel test.
+	template <typename Run, typename... Tests>
+	bool specialize(const Predicate* rest, const Predicate* end, std::chrono::sys_days today, Run& run, const Tests&... tests)
+	{
+		if (rest == end)
+		{
+			run(tests...);
+			return true;
+		}
+		if constexpr (sizeof...(Tests) < maxKernelTests)
+		{
+			using kernels::DateTest, kernels::Dates;
+			const Predicate& predicate = *rest;
+			auto next = [&](const auto& test) { return specialize(rest + 1, end, today, run, tests..., test); };
+			switch (predicate.kind)
+			{
+			case Kind::NoCategory:
+				return next(kernels::NoCategory{});
+			case Kind::Categories:
+				return next(kernels::InCategories<false>{ &predicate.categories });
+			case Kind::DescriptionPrefix:
+				return next(kernels::DescriptionPrefix{ predicate.text });
+			case Kind::Match:
+				return next(kernels::Match{ predicate.regex.get() });
+			case Kind::Today:
+				return next(Dates<DateTest::On>{ std::chrono::year_month_day{ today }, {} });
+			case Kind::OnDate:
+				return next(Dates<DateTest::On>{ predicate.date1, {} });
+			case Kind::Before:
+				return next(Dates<DateTest::Before>{ predicate.date1, {} });
+			case Kind::After:
+				return next(Dates<DateTest::After>{ predicate.date1, {} });
+			case Kind::Between:
+				return next(Dates<DateTest::Between>{ predicate.date1, predicate.date2 });
+			case Kind::Not:
+				if (predicate.operand.front().kind == Kind::Categories)
+				{
+					return next(kernels::InCategories<true>{ &predicate.operand.front().categories });
+				}
+				return false;
+			}
+		}
+		return false;
+	}
+
+	// The generic row test: all predicates but `skip` must hold.
+	bool passes(const std::vector<Predicate>& terms, const EventTable& table, std::size_t row,
+		std::chrono::sys_days today, const Predicate* skip)
+	{
+		if (table.erased(row))
+		{
+			return false;
+		}
+		for (const Predicate& predicate : terms)
+		{
+			if (&predicate != skip && !test(predicate, table, row, today))
+			{
+				return false;
+			}
+		}
+		return table.date(row).has_value();
+	}
+
+	// A copy of `terms` for another thread. A `Regex` caches DFA states as
+	// it matches, so every thread needs its own.
+	std::vector<Predicate> threadCopy(const std::vector<Predicate>& terms)
+	{
+		std::vector<Predicate> copy = terms;
+		for (Predicate& predicate : copy)
+		{
+			Predicate& inner = predicate.kind == Kind::Not ? predicate.operand.front() : predicate;
+			if (inner.regex)
+			{
+				inner.regex = std::make_shared<const Regex>(*inner.regex);
+			}
+		}
+		return copy;
+	}
+
+	// Date and category predicates can be answered from the dense columns
+	// of the table; the rest need the text fields.
+	bool isColumnar(const Predicate& predicate)
+	{
+		if (predicate.kind == Kind::Not)
+		{
+			return isColumnar(predicate.operand.front());
+		}
+		return predicate.kind != Kind::DescriptionPrefix && predicate.kind != Kind::Match;
+	}
+
+	std::int32_t daySerial(const std::chrono::year_month_day& date)
+	{
+		return static_cast<std::int32_t>(std::chrono::sys_days{ date }.time_since_epoch().count());
+	}
+
+	// Sets `out` to the rows passing a columnar, non-negated `predicate`.
+	void selectColumnar(const Predicate& predicate, const EventTable& table, std::chrono::sys_days today, simd::Bitmap& out)
+	{
+		constexpr std::int32_t earliest = EventTable::invalidDay + 1;
+		constexpr std::int32_t latest = std::numeric_limits<std::int32_t>::max();
+		auto range = [&](std::int32_t low, std::int32_t high)
+		{
+			const std::vector<std::int32_t>& days = table.daySerials();
+			simd::selectRange(days.data(), days.size(), low, high, out);
+		};
+		// Category filters are answered from the per-category bitmaps: the
+		// union is computed on the compressed sets before any row is touched.
+		auto categories = [&](const std::vector<std::string>& names)
+		{
+			RoaringBitmap selected;
+			for (const std::string& name : names)
+			{
+				if (auto id = table.categoryId(name))
+				{
+					selected |= table.categoryRows(id.value());
+				}
+			}
+			out.assign(simd::wordsFor(table.size()), 0);
+			selected.setBitsIn(out);
+		};
+
+		switch (predicate.kind)
+		{
+		case Kind::Today:
+			range(static_cast<std::int32_t>(today.time_since_epoch().count()), static_cast<std::int32_t>(today.time_since_epoch().count()));
+			break;
+		case Kind::OnDate:
+			range(daySerial(predicate.date1), daySerial(predicate.date1));
+			break;
+		case Kind::Before:
+			range(earliest, daySerial(predicate.date1) - 1);
+			break;
+		case Kind::After:
+			range(daySerial(predicate.date1) + 1, latest);
+			break;
+		case Kind::Between:
+			range(daySerial(predicate.date1), daySerial(predicate.date2));
+			break;
+		case Kind::Categories:
+			categories(predicate.categories);
+			break;
+		case Kind::NoCategory:
+			// A single precomputed bitmap.
+			out.assign(simd::wordsFor(table.size()), 0);
+			if (auto id = table.categoryId(""))
+			{
+				table.categoryRows(id.value()).setBitsIn(out);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+std::optional<Query> Query::parse(const std::vector<std::string>& args, std::string& error)
+{
+	Query query;
+	bool negate = false;
+	for (std::size_t i{ 0 }; i < args.size(); i++)
+	{
+		const std::string& option = args[i];
+
+		// Returns the word after the option, or nullptr if there is none.
+		auto value = [&](const char* missing) -> const std::string*
+		{
+			if (i + 1 >= args.size())
+			{
+				error = missing;
+				return nullptr;
+			}
+			return &args[++i];
+		};
+
+		Predicate predicate;
+		if (option == "--all")
+		{
+			continue;
+		}
+		else if (option == "--not")
+		{
+			negate = true;
+			continue;
+		}
+		else if (option == "--exclude")
+		{
+			// `--categories a,b --exclude` negates the category filter before it.
+			if (query.terms.empty() || query.terms.back().kind != Kind::Categories)
+			{
+				error = "--exclude must follow --categories";
+				return std::nullopt;
+			}
+			Predicate negated;
+			negated.kind = Kind::Not;
+			negated.operand.push_back(std::move(query.terms.back()));
+			query.terms.back() = std::move(negated);
+			continue;
+		}
+		else if (option == "--today")
+		{
+			predicate.kind = Kind::Today;
+		}
+		else if (option == "--before-date" || option == "--after-date" || option == "--date")
+		{
+			if (!parseDate(args, ++i, predicate.date1, error))
+			{
+				return std::nullopt;
+			}
+			predicate.kind = option == "--before-date" ? Kind::Before
+				: option == "--after-date" ? Kind::After
+				: Kind::OnDate;
+
+			// `--before-date A --after-date B` has always listed the events
+			// outside of A..B, so it stays a union: `--not --between A B`.
+			if (predicate.kind == Kind::After && !negate && i >= 3 && args[i - 3] == "--before-date"
+				&& !query.terms.empty() && query.terms.back().kind == Kind::Before)
+			{
+				Predicate between;
+				between.kind = Kind::Between;
+				between.date1 = query.terms.back().date1;
+				between.date2 = predicate.date1;
+				query.terms.back().kind = Kind::Not;
+				query.terms.back().operand.push_back(std::move(between));
+				continue;
+			}
+		}
+		else if (option == "--between")
+		{
+			if (!parseDate(args, i + 1, predicate.date1, error) || !parseDate(args, i + 2, predicate.date2, error))
+			{
+				return std::nullopt;
+			}
+			i += 2;
+			predicate.kind = Kind::Between;
+		}
+		else if (option == "--categories" || option == "--category")
+		{
+			const std::string* categories = value("No category given");
+			if (categories == nullptr)
+			{
+				return std::nullopt;
+			}
+			predicate.kind = Kind::Categories;
+			predicate.categories = option == "--categories" ? splitCommas(*categories) : std::vector<std::string>{ *categories };
+		}
+		else if (option == "--no-category")
+		{
+			predicate.kind = Kind::NoCategory;
+		}
+		else if (option == "--description-prefix" || option == "--description")
+		{
+			const std::string* prefix = value("No description given");
+			if (prefix == nullptr)
+			{
+				return std::nullopt;
+			}
+			predicate.kind = Kind::DescriptionPrefix;
+			predicate.text = *prefix;
+		}
+		else if (option == "--match")
+		{
+			const std::string* pattern = value("No regular expression given");
+			if (pattern == nullptr)
+			{
+				return std::nullopt;
+			}
+			std::string message;
+			auto regex = Regex::compile(*pattern, message);
+			if (!regex.has_value())
+			{
+				error = "bad regular expression: " + message;
+				return std::nullopt;
+			}
+			predicate.kind = Kind::Match;
+			predicate.regex = std::make_shared<const Regex>(std::move(regex.value()));
+		}
+		else
+		{
+			error = "unknown option: " + option;
+			return std::nullopt;
+		}
+
+		if (negate)
+		{
+			Predicate negated;
+			negated.kind = Kind::Not;
+			negated.operand.push_back(std::move(predicate));
+			predicate = std::move(negated);
+			negate = false;
+		}
+		query.terms.push_back(std::move(predicate));
+	}
+
+	if (negate)
+	{
+		error = "--not must be followed by a filter";
+		return std::nullopt;
+	}
+
+	// The plan: cheapest predicates first, so a row is rejected as early as
+	// possible. The sort is stable to keep equal predicates in given order.
+	std::stable_sort(query.terms.begin(), query.terms.end(),
+		[](const Predicate& a, const Predicate& b) { return rank(a) < rank(b); });
+	return query;
+}
+
+bool Query::matches(const EventTable& table, std::size_t row, std::chrono::sys_days today) const
+{
+	return passes(terms, table, row, today, nullptr);
+}
+
+bool Query::usesDescriptionIndex() const
+{
+	return std::any_of(terms.begin(), terms.end(),
+		[](const Predicate& predicate) { return predicate.kind == Kind::DescriptionPrefix; });
+}
+
+bool Query::usesColumns(const EventTable& table) const
+{
+	return table.hasColumns() && !terms.empty() && std::all_of(terms.begin(), terms.end(), isColumnar);
+}
+
+std::vector<std::size_t> Query::execute(const EventTable& table, std::chrono::sys_days today, const DescriptionIndex* index) const
+{
+	std::vector<std::size_t> rows;
+
+	// With an index the prefix predicate is the access path: its rows are the
+	// only candidates, and the remaining predicates filter them.
+	if (index != nullptr)
+	{
+		auto prefix = std::find_if(terms.begin(), terms.end(),
+			[](const Predicate& predicate) { return predicate.kind == Kind::DescriptionPrefix; });
+		if (prefix != terms.end())
+		{
+			for (std::size_t row : index->withPrefix(prefix->text))
+			{
+				if (passes(terms, table, row, today, &*prefix))
+				{
+					rows.push_back(row);
+				}
+			}
+			return rows;
+		}
+	}
+
+	// Only date and category filters: every predicate becomes a match bitmap
+	// computed with vectorized compares over the dense columns, and the
+	// bitmaps are intersected.
+	if (usesColumns(table))
+	{
+		simd::Bitmap selected(simd::wordsFor(table.size()), ~std::uint64_t{ 0 });
+		simd::Bitmap bits;
+		for (const Predicate& predicate : terms)
+		{
+			const bool negated = predicate.kind == Kind::Not;
+			selectColumnar(negated ? predicate.operand.front() : predicate, table, today, bits);
+			if (negated)
+			{
+				simd::andNotBits(selected, bits);
+			}
+			else
+			{
+				simd::andBits(selected, bits);
+			}
+		}
+		// The date column is cached by now if a date was compared; otherwise
+		// only the dates of the selected rows get parsed.
+		for (std::size_t row : simd::setRows(selected))
+		{
+			if (row < table.size() && !table.erased(row) && table.date(row).has_value())
+			{
+				rows.push_back(row);
+			}
+		}
+		return rows;
+	}
+
+	// Otherwise the rows are scanned in the loop specialized for the
+	// predicates. Large tables are split into one chunk per thread; each
+	// thread collects the matches of its chunk and the lists are joined in
+	// chunk order, so the result is the same as that of a serial scan. So
+	// are the messages about bad dates, which are held back per chunk.
+	struct Chunk
+	{
+		std::size_t begin;
+		std::vector<std::size_t> found;
+		std::string messages;
+	};
+	std::mutex lock;
+	std::vector<Chunk> chunks;
+	parallelFor(table.size(), parallelRowsPerThread, [&](std::size_t begin, std::size_t end)
+		{
+			EventTable::DeferredMessages messages;
+			const std::vector<Predicate> local = threadCopy(terms);
+			std::vector<std::size_t> found;
+			auto run = [&](const auto&... tests) { kernels::scan(table, begin, end, found, tests...); };
+			if (!specialize(local.data(), local.data() + local.size(), today, run))
+			{
+				for (std::size_t row{ begin }; row < end; row++)
+				{
+					if (passes(local, table, row, today, nullptr))
+					{
+						found.push_back(row);
+					}
+				}
+			}
+			std::lock_guard guard(lock);
+			chunks.push_back(Chunk{ begin, std::move(found), std::move(messages.text) });
+		});
+
+	std::sort(chunks.begin(), chunks.end(), [](const Chunk& a, const Chunk& b) { return a.begin < b.begin; });
+	for (const Chunk& chunk : chunks)
+	{
+		std::cerr << chunk.messages;
+	}
+	if (chunks.size() == 1)
+	{
+		return std::move(chunks.front().found);
+	}
+	for (const Chunk& chunk : chunks)
+	{
+		rows.insert(rows.end(), chunk.found.begin(), chunk.found.end());
+	}
+	return rows;
+}
+
+std::vector<QuerySpec> readQuerySpecs(std::istream& input)
+{
+	std::vector<QuerySpec> specs;
+	std::string line;
+	while (std::getline(input, line))
+	{
+		std::vector<std::string> words = splitWords(line);
+		if (words.empty() || words[0].starts_with("#"))
+		{
+			continue;
+		}
+		if (words[0] == "list")
+		{
+			words.erase(words.begin());
+		}
+
+		QuerySpec spec;
+		spec.text = line;
+		if (!spec.text.empty() && spec.text.back() == '\r')
+		{
+			spec.text.pop_back();
+		}
+		spec.query = Query::parse(words, spec.error);
+		specs.push_back(spec);
+	}
+	return specs;
+}
+
+std::vector<std::vector<std::size_t>> evaluateQueries(
+	const EventTable& table, const std::vector<QuerySpec>& specs, std::chrono::sys_days today)
+{
+	std::vector<std::vector<std::size_t>> results(specs.size());
+
+	// Prefix queries go to the description index.
+	std::vector<std::size_t> scanned;
+	std::unique_ptr<DescriptionIndex> index;
+	for (std::size_t i{ 0 }; i < specs.size(); i++)
+	{
+		if (!specs[i].query.has_value())
+		{
+			continue;
+		}
+		if (specs[i].query->usesDescriptionIndex())
+		{
+			if (!index)
+			{
+				index = std::make_unique<DescriptionIndex>(table);
+			}
+			results[i] = specs[i].query->execute(table, today, index.get());
+		}
+		else
+		{
+			scanned.push_back(i);
+		}
+	}
+
+	// With several queries the dense columns pay off; date and category
+	// queries then run on them one by one.
+	if (scanned.size() > 1)
+	{
+		table.buildColumns();
+	}
+	std::erase_if(scanned, [&](std::size_t i)
+		{
+			if (!specs[i].query->usesColumns(table))
+			{
+				return false;
+			}
+			results[i] = specs[i].query->execute(table, today);
+			return true;
+		});
+
+	// One pass over the rows; every query looks at the row while it is hot.
+	if (!scanned.empty())
+	{
+		for (std::size_t row{ 0 }; row < table.size(); row++)
+		{
+			for (std::size_t i : scanned)
+			{
+				if (specs[i].query->matches(table, row, today))
+				{
+					results[i].push_back(row);
+				}
+			}
+		}
+	}
+	return results;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "EventTable.h"
+#include "Regex.h"
+
+class DescriptionIndex;
+
+// An event filter, parsed from the options that `days list` and `days delete`
+// accept on the command line. Options can be combined freely and an event
+// has to pass all of them, for example
+// `--categories work,school --exclude --after-date 2024-01-01 --match "^Meet"`.
+// The one exception is `--before-date A --after-date B` right after one
+// another, which keeps its old meaning of events outside of A..B.
+//
+// Every option becomes a predicate. `parse()` also plans the query: the
+// predicates are ordered so that the cheap and selective ones run first and
+// the date is only parsed for rows that survive them. A description prefix
+// can be answered from a `DescriptionIndex`, in which case only the rows it
+// returns are looked at, and date and category filters from the dense
+// columns of the table if it has them. Either way `execute()` makes one pass.
+class Query
+{
+public:
+	struct Predicate
+	{
+		enum class Kind { Today, Before, After, OnDate, Between, Categories, NoCategory, DescriptionPrefix, Match, Not };
+
+		Kind kind{ Kind::Today };
+		std::chrono::year_month_day date1{};
+		std::chrono::year_month_day date2{};
+		std::vector<std::string> categories;
+		std::string text;					// description prefix
+		std::shared_ptr<const Regex> regex; // shared by copies of the query
+		std::vector<Predicate> operand;		// the negated predicate of `Not`
+	};
+
+	// Parses filter options. On failure returns `std::nullopt` and describes
+	// the problem in `error`. No options, or just `--all`, select every event.
+	static std::optional<Query> parse(const std::vector<std::string>& args, std::string& error);
+
+	// Returns true if `row` of `table` passes the filter. Erased rows and rows
+	// without a valid date never do.
+	bool matches(const EventTable& table, std::size_t row, std::chrono::sys_days today) const;
+
+	// Rows of `table` that pass the filter, in file order. If `index` is given
+	// and the query has a description prefix, the prefix is looked up in it.
+	std::vector<std::size_t> execute(const EventTable& table, std::chrono::sys_days today,
+		const DescriptionIndex* index = nullptr) const;
+
+	// Returns true if `execute()` can use a description index.
+	bool usesDescriptionIndex() const;
+
+	// Returns true if `execute()` answers the query from the dense columns
+	// of `table` with vectorized compares: the table has them and the query
+	// only filters by date and category.
+	bool usesColumns(const EventTable& table) const;
+
+	// The predicates in evaluation order; all of them must hold.
+	const std::vector<Predicate>& predicates() const { return terms; }
+
+private:
+	std::vector<Predicate> terms;
+};
+
+// Splits a command line read from a file into words on whitespace.
+// Double quotes group words, so `--description "New year"` yields two words.
+std::vector<std::string> splitWords(const std::string& line);
+
+// Splits a comma separated option value such as `work,school`.
+std::vector<std::string> splitCommas(const std::string& text);
+
+// One line of a batch query file together with its parse result.
+struct QuerySpec
+{
+	std::string text;
+	std::optional<Query> query;
+	std::string error;
+};
+
+// Reads query specs from `input`, one per line. Blank lines and lines starting
+// with `#` are skipped, and a leading `list` word is optional.
+std::vector<QuerySpec> readQuerySpecs(std::istream& input);
+
+// Evaluates all valid `specs` over `table` and returns the matching rows of
+// each spec, in file order. Description prefix queries are answered from a
+// `DescriptionIndex` and date and category queries from the dense columns
+// of the table; all other specs share a single scan over the rows.
+std::vector<std::vector<std::size_t>> evaluateQueries(
+	const EventTable& table, const std::vector<QuerySpec>& specs, std::chrono::sys_days today);
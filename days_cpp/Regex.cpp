@@ -0,0 +1,460 @@
+#include "Regex.h"
+
+#include <algorithm> // for sorting node sets
+
+// Recursive descent parser producing the NFA with Thompson's construction.
+// Every fragment has one entry node and a list of dangling exits ("holes")
+// that get patched to whatever follows the fragment.
+class Regex::Parser
+{
+public:
+	Parser(std::string_view text, std::vector<Node>& output)
+		: pattern(text)
+		, nodes(output)
+	{
+	}
+
+	// Parses the whole pattern and returns the entry node, or -1 on error.
+	int parse(std::string& error)
+	{
+		auto fragment = alternation();
+		if (fragment.has_value() && pos < pattern.size())
+		{
+			fail(pattern[pos] == ')' ? "unmatched )" : "unexpected character");
+		}
+		if (!message.empty())
+		{
+			error = message + " at position " + std::to_string(pos);
+			return -1;
+		}
+		const int match = add(node(Kind::Match));
+		patch(fragment->holes, match);
+		return fragment->start;
+	}
+
+private:
+	struct Fragment
+	{
+		int start;
+		std::vector<int> holes; // node * 2 for `next`, node * 2 + 1 for `alt`
+	};
+
+	static Node node(Kind kind)
+	{
+		Node result;
+		result.kind = kind;
+		return result;
+	}
+
+	int add(const Node& added)
+	{
+		nodes.push_back(added);
+		return static_cast<int>(nodes.size() - 1);
+	}
+
+	void patch(const std::vector<int>& holes, int target)
+	{
+		for (int hole : holes)
+		{
+			Node& node = nodes[hole / 2];
+			(hole % 2 == 0 ? node.next : node.alt) = target;
+		}
+	}
+
+	void fail(const std::string& text)
+	{
+		if (message.empty())
+		{
+			message = text;
+		}
+	}
+
+	bool atEnd() const
+	{
+		return pos >= pattern.size();
+	}
+
+	Fragment single(Kind kind, const std::bitset<256>& bytes = {})
+	{
+		Node added = node(kind);
+		added.bytes = bytes;
+		const int index = add(added);
+		return Fragment{ index, { index * 2 } };
+	}
+
+	std::optional<Fragment> alternation()
+	{
+		auto left = concatenation();
+		while (left.has_value() && !atEnd() && pattern[pos] == '|')
+		{
+			pos++;
+			auto right = concatenation();
+			if (!right.has_value())
+			{
+				return std::nullopt;
+			}
+			Node split = node(Kind::Split);
+			split.next = left->start;
+			split.alt = right->start;
+			Fragment both{ add(split), left->holes };
+			both.holes.insert(both.holes.end(), right->holes.begin(), right->holes.end());
+			left = both;
+		}
+		return left;
+	}
+
+	std::optional<Fragment> concatenation()
+	{
+		std::optional<Fragment> result;
+		while (!atEnd() && pattern[pos] != '|' && pattern[pos] != ')')
+		{
+			auto next = repetition();
+			if (!next.has_value())
+			{
+				return std::nullopt;
+			}
+			if (!result.has_value())
+			{
+				result = next;
+			}
+			else
+			{
+				patch(result->holes, next->start);
+				result->holes = next->holes;
+			}
+		}
+		if (!result.has_value())
+		{
+			return single(Kind::Empty); // empty branch, as in `a|` or `()`
+		}
+		return result;
+	}
+
+	std::optional<Fragment> repetition()
+	{
+		auto fragment = atom();
+		while (fragment.has_value() && !atEnd() && (pattern[pos] == '*' || pattern[pos] == '+' || pattern[pos] == '?'))
+		{
+			const char op = pattern[pos++];
+			Node split = node(Kind::Split);
+			split.next = fragment->start;
+			const int index = add(split);
+			const int exit = index * 2 + 1;
+			if (op == '*')
+			{
+				patch(fragment->holes, index);
+				fragment = Fragment{ index, { exit } };
+			}
+			else if (op == '+')
+			{
+				patch(fragment->holes, index);
+				fragment = Fragment{ fragment->start, { exit } };
+			}
+			else
+			{
+				fragment->start = index;
+				fragment->holes.push_back(exit);
+			}
+		}
+		return fragment;
+	}
+
+	// Returns the byte set of the escape `\c`.
+	std::bitset<256> escape(char c)
+	{
+		std::bitset<256> bytes;
+		auto range = [&](char first, char last)
+		{
+			for (int b = static_cast<unsigned char>(first); b <= static_cast<unsigned char>(last); b++)
+			{
+				bytes.set(static_cast<std::size_t>(b));
+			}
+		};
+		switch (c)
+		{
+		case 'd': case 'D':
+			range('0', '9');
+			break;
+		case 'w': case 'W':
+			range('0', '9');
+			range('a', 'z');
+			range('A', 'Z');
+			bytes.set('_');
+			break;
+		case 's': case 'S':
+			for (char space : { ' ', '\t', '\n', '\r', '\f', '\v' })
+			{
+				bytes.set(static_cast<unsigned char>(space));
+			}
+			break;
+		case 't':
+			bytes.set('\t');
+			break;
+		case 'n':
+			bytes.set('\n');
+			break;
+		default:
+			if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+			{
+				fail(std::string{ "unknown escape \\" } + c);
+			}
+			bytes.set(static_cast<unsigned char>(c));
+		}
+		if (c == 'D' || c == 'W' || c == 'S')
+		{
+			bytes.flip();
+		}
+		return bytes;
+	}
+
+	std::optional<Fragment> byteClass()
+	{
+		std::bitset<256> bytes;
+		const bool negated = !atEnd() && pattern[pos] == '^';
+		if (negated)
+		{
+			pos++;
+		}
+		bool first = true;
+		while (!atEnd() && (pattern[pos] != ']' || first))
+		{
+			first = false;
+			char low = pattern[pos++];
+			if (low == '\\' && !atEnd())
+			{
+				bytes |= escape(pattern[pos++]);
+				continue;
+			}
+			char high = low;
+			if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']')
+			{
+				high = pattern[pos + 1];
+				pos += 2;
+			}
+			if (static_cast<unsigned char>(high) < static_cast<unsigned char>(low))
+			{
+				fail("bad range");
+				return std::nullopt;
+			}
+			for (int b = static_cast<unsigned char>(low); b <= static_cast<unsigned char>(high); b++)
+			{
+				bytes.set(static_cast<std::size_t>(b));
+			}
+		}
+		if (atEnd())
+		{
+			fail("missing ]");
+			return std::nullopt;
+		}
+		pos++; // ]
+		if (negated)
+		{
+			bytes.flip();
+		}
+		return single(Kind::Bytes, bytes);
+	}
+
+	std::optional<Fragment> atom()
+	{
+		const char c = pattern[pos++];
+		switch (c)
+		{
+		case '(':
+		{
+			auto inner = alternation();
+			if (!inner.has_value())
+			{
+				return std::nullopt;
+			}
+			if (atEnd() || pattern[pos] != ')')
+			{
+				fail("missing )");
+				return std::nullopt;
+			}
+			pos++;
+			return inner;
+		}
+		case '[':
+			return byteClass();
+		case '.':
+		{
+			std::bitset<256> bytes;
+			bytes.set();
+			bytes.reset('\n');
+			return single(Kind::Bytes, bytes);
+		}
+		case '^':
+			return single(Kind::LineStart);
+		case '$':
+			return single(Kind::LineEnd);
+		case '*': case '+': case '?':
+			fail("nothing to repeat");
+			return std::nullopt;
+		case '\\':
+		{
+			if (atEnd())
+			{
+				fail("trailing \\");
+				return std::nullopt;
+			}
+			auto bytes = escape(pattern[pos++]);
+			if (!message.empty())
+			{
+				return std::nullopt;
+			}
+			return single(Kind::Bytes, bytes);
+		}
+		default:
+		{
+			std::bitset<256> bytes;
+			bytes.set(static_cast<unsigned char>(c));
+			return single(Kind::Bytes, bytes);
+		}
+		}
+	}
+
+	std::string_view pattern;
+	std::vector<Node>& nodes;
+	std::size_t pos{ 0 };
+	std::string message;
+};
+
+std::optional<Regex> Regex::compile(std::string_view pattern, std::string& error)
+{
+	Regex regex;
+	Parser parser(pattern, regex.nodes);
+	regex.start = parser.parse(error);
+	if (regex.start < 0)
+	{
+		return std::nullopt;
+	}
+	return regex;
+}
+
+// Follows the epsilon edges from `seeds`. `^` only passes at the start of
+// the text; `$` nodes are kept in the set and only followed at its end.
+std::vector<int> Regex::closure(std::vector<int> seeds, bool atStart) const
+{
+	std::vector<int> result;
+	std::vector<bool> seen(nodes.size());
+	while (!seeds.empty())
+	{
+		const int index = seeds.back();
+		seeds.pop_back();
+		if (index < 0 || seen[index])
+		{
+			continue;
+		}
+		seen[index] = true;
+
+		const Node& node = nodes[index];
+		switch (node.kind)
+		{
+		case Kind::Split:
+			seeds.push_back(node.alt);
+			seeds.push_back(node.next);
+			break;
+		case Kind::Empty:
+			seeds.push_back(node.next);
+			break;
+		case Kind::LineStart:
+			if (atStart)
+			{
+				seeds.push_back(node.next);
+			}
+			break;
+		default:
+			result.push_back(index);
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+int Regex::stateFor(std::vector<int> set) const
+{
+	auto found = stateIds.find(set);
+	if (found != stateIds.end())
+	{
+		return found->second;
+	}
+
+	DfaState state;
+	state.next.fill(-1);
+	std::vector<int> atEnd;
+	for (int index : set)
+	{
+		if (nodes[index].kind == Kind::Match)
+		{
+			state.accepting = true;
+		}
+		else if (nodes[index].kind == Kind::LineEnd)
+		{
+			atEnd.push_back(nodes[index].next);
+		}
+	}
+	state.acceptingAtEnd = state.accepting;
+	for (int index : closure(atEnd, false))
+	{
+		if (nodes[index].kind == Kind::Match)
+		{
+			state.acceptingAtEnd = true;
+		}
+	}
+	state.nodes = set;
+
+	states.push_back(std::move(state));
+	const int id = static_cast<int>(states.size() - 1);
+	stateIds.emplace(std::move(set), id);
+	return id;
+}
+
+int Regex::step(int state, unsigned char byte) const
+{
+	int next = states[state].next[byte];
+	if (next >= 0)
+	{
+		return next;
+	}
+
+	// Keeping a fresh copy of the start node in every set lets a match begin
+	// at any position without trying each start position separately.
+	std::vector<int> seeds{ start };
+	for (int index : states[state].nodes)
+	{
+		if (nodes[index].kind == Kind::Bytes && nodes[index].bytes.test(byte))
+		{
+			seeds.push_back(nodes[index].next);
+		}
+	}
+	next = stateFor(closure(seeds, false));
+	states[state].next[byte] = next;
+	return next;
+}
+
+bool Regex::search(std::string_view text) const
+{
+	// A pathological pattern could create very many DFA states; start over
+	// rather than grow the cache without bound.
+	if (states.size() > maxCachedStates)
+	{
+		states.clear();
+		stateIds.clear();
+		startState = -1;
+	}
+	if (startState < 0)
+	{
+		startState = stateFor(closure({ start }, true));
+	}
+
+	int state = startState;
+	for (char c : text)
+	{
+		if (states[state].accepting)
+		{
+			return true;
+		}
+		state = step(state, static_cast<unsigned char>(c));
+	}
+	return states[state].acceptingAtEnd;
+}
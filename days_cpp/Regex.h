@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Regular expression matcher that runs in linear time.
+//
+// The pattern is compiled to a Thompson NFA, and `search()` walks a DFA that
+// is built from it lazily: each DFA state is a set of NFA states, and its
+// transition for a byte is computed the first time that byte is seen in that
+// state and then cached. After warming up, matching costs one table lookup
+// per byte of text with no backtracking, whatever the pattern.
+//
+// Supported syntax: literals, `.`, `[abc]`, `[^a-z]`, `*`, `+`, `?`, `|`,
+// `(...)`, `^`, `$` and the escapes `\d`, `\w`, `\s` (and their upper case
+// negations), `\t`, `\n` and `\` before any punctuation. Matching is byte
+// based and case-sensitive. `search()` looks for a match anywhere in the
+// text, like grep.
+//
+// The DFA cache makes `search()` non-const in effect, so one `Regex` must
+// not be used from several threads at the same time.
+class Regex
+{
+public:
+	// Compiles `pattern`. On failure returns `std::nullopt` and describes the
+	// problem in `error`.
+	static std::optional<Regex> compile(std::string_view pattern, std::string& error);
+
+	// Returns true if some substring of `text` matches the pattern.
+	bool search(std::string_view text) const;
+
+private:
+	enum class Kind : std::uint8_t { Bytes, Split, Empty, LineStart, LineEnd, Match };
+
+	struct Node
+	{
+		Kind kind{ Kind::Empty };
+		std::bitset<256> bytes;
+		int next{ -1 };
+		int alt{ -1 };
+	};
+
+	struct DfaState
+	{
+		std::vector<int> nodes; // sorted NFA nodes: Bytes, LineEnd and Match only
+		std::array<int, 256> next;
+		bool accepting{ false };
+		bool acceptingAtEnd{ false };
+	};
+
+	class Parser;
+
+	std::vector<int> closure(std::vector<int> seeds, bool atStart) const;
+	int stateFor(std::vector<int> nodes) const;
+	int step(int state, unsigned char byte) const;
+
+	std::vector<Node> nodes;
+	int start{ 0 };
+
+	static constexpr std::size_t maxCachedStates = 4096;
+	mutable std::vector<DfaState> states;
+	mutable std::map<std::vector<int>, int> stateIds;
+	mutable int startState{ -1 };
+};
@@ -0,0 +1,121 @@
+#include "RoaringBitmap.h"
+
+#include <algorithm> // for merging arrays
+#include <bit>		 // for std::popcount
+#include <iterator>	 // for std::back_inserter
+
+void RoaringBitmap::Container::toBitmap()
+{
+	if (isBitmap())
+	{
+		return;
+	}
+	bits.assign(chunkWords, 0);
+	for (std::uint16_t low : values)
+	{
+		bits[low >> 6] |= std::uint64_t{ 1 } << (low & 63);
+	}
+	values = {};
+}
+
+void RoaringBitmap::append(std::uint32_t row)
+{
+	const auto key = static_cast<std::uint16_t>(row >> 16);
+	const auto low = static_cast<std::uint16_t>(row & 0xFFFF);
+	if (containers.empty() || containers.back().key != key)
+	{
+		containers.push_back(Container{ key, {}, {}, 0 });
+	}
+
+	Container& container = containers.back();
+	container.count++;
+	if (container.isBitmap())
+	{
+		container.bits[low >> 6] |= std::uint64_t{ 1 } << (low & 63);
+		return;
+	}
+	container.values.push_back(low);
+	if (container.values.size() > maxArraySize)
+	{
+		container.toBitmap();
+	}
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other)
+{
+	std::vector<Container> merged;
+	merged.reserve(containers.size() + other.containers.size());
+	auto mine = containers.begin();
+	auto theirs = other.containers.begin();
+	while (mine != containers.end() || theirs != other.containers.end())
+	{
+		if (theirs == other.containers.end() || (mine != containers.end() && mine->key < theirs->key))
+		{
+			merged.push_back(std::move(*mine++));
+			continue;
+		}
+		if (mine == containers.end() || theirs->key < mine->key)
+		{
+			merged.push_back(*theirs++);
+			continue;
+		}
+
+		Container both = std::move(*mine++);
+		const Container& added = *theirs++;
+		if (!both.isBitmap() && !added.isBitmap() && both.count + added.count <= maxArraySize)
+		{
+			std::vector<std::uint16_t> values;
+			values.reserve(both.count + added.count);
+			std::set_union(both.values.begin(), both.values.end(), added.values.begin(), added.values.end(), std::back_inserter(values));
+			both.values = std::move(values);
+			both.count = static_cast<std::uint32_t>(both.values.size());
+		}
+		else
+		{
+			both.toBitmap();
+			if (added.isBitmap())
+			{
+				for (std::size_t word{ 0 }; word < chunkWords; word++)
+				{
+					both.bits[word] |= added.bits[word];
+				}
+			}
+			else
+			{
+				for (std::uint16_t low : added.values)
+				{
+					both.bits[low >> 6] |= std::uint64_t{ 1 } << (low & 63);
+				}
+			}
+			both.count = 0;
+			for (std::uint64_t word : both.bits)
+			{
+				both.count += static_cast<std::uint32_t>(std::popcount(word));
+			}
+		}
+		merged.push_back(std::move(both));
+	}
+	containers = std::move(merged);
+	return *this;
+}
+
+void RoaringBitmap::setBitsIn(std::vector<std::uint64_t>& words) const
+{
+	for (const Container& container : containers)
+	{
+		const std::size_t first = static_cast<std::size_t>(container.key) * chunkWords;
+		if (container.isBitmap())
+		{
+			const std::size_t last = std::min(words.size(), first + chunkWords);
+			for (std::size_t word{ first }; word < last; word++)
+			{
+				words[word] |= container.bits[word - first];
+			}
+			continue;
+		}
+		for (std::uint16_t low : container.values)
+		{
+			words[first + (low >> 6)] |= std::uint64_t{ 1 } << (low & 63);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed set of 32-bit row numbers in the style of Roaring bitmaps.
+//
+// The rows are split into chunks of 65536 by their upper 16 bits. A chunk
+// with few rows stores their lower 16 bits as a sorted array; once it holds
+// more than 4096 rows it switches to a plain 8 KB bitmap, which is then the
+// smaller of the two. Sparse categories cost two bytes per row, dense ones
+// one bit, and a union works a chunk at a time.
+class RoaringBitmap
+{
+public:
+	// Adds `row`, which must be larger than every row added before.
+	void append(std::uint32_t row);
+
+	// Set union.
+	RoaringBitmap& operator|=(const RoaringBitmap& other);
+
+	// Sets the bits of the rows in `words`, a dense bitmap with bit `i % 64`
+	// of word `i / 64` for row `i` that is large enough for every row.
+	void setBitsIn(std::vector<std::uint64_t>& words) const;
+
+private:
+	static constexpr std::size_t maxArraySize = 4096;
+	static constexpr std::size_t chunkWords = 65536 / 64;
+
+	struct Container
+	{
+		std::uint16_t key{ 0 };				// upper 16 bits of the rows
+		std::vector<std::uint16_t> values;	// sorted lower bits, if an array
+		std::vector<std::uint64_t> bits;	// chunkWords words, if a bitmap
+		std::uint32_t count{ 0 };
+
+		bool isBitmap() const { return !bits.empty(); }
+		void toBitmap();
+	};
+
+	std::vector<Container> containers; // sorted by key
+};
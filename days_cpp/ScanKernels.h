@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EventTable.h"
+#include "Regex.h"
+
+// Row tests used by the specialized scan loops of `Query::execute()`.
+//
+// Each test is a small function object for one filter. `scan()` is a
+// template over the tests of a query, so every combination of filters gets
+// its own loop in which the tests are inlined and nothing is decided at run
+// time except the comparisons themselves. `readsDate` tells the loop that
+// the test already rejects rows without a valid date.
+namespace kernels
+{
+	struct NoCategory
+	{
+		static constexpr bool readsDate = false;
+
+		bool operator()(const EventTable& table, std::size_t row) const
+		{
+			return table.category(row).empty();
+		}
+	};
+
+	// `--categories`, or with `Excluded` set, `--categories ... --exclude`.
+	// Only one-shot `days list` and `days delete` get here: tables with dense
+	// columns, as in `days batch` and `days query`, answer category lists
+	// from the per-category bitmaps instead. Building those bitmaps costs a
+	// hash per row, more than searching a short list, so a single scan
+	// doesn't build them.
+	template <bool Excluded>
+	struct InCategories
+	{
+		static constexpr bool readsDate = false;
+
+		const std::vector<std::string>* categories;
+
+		bool operator()(const EventTable& table, std::size_t row) const
+		{
+			const std::string_view category = table.category(row);
+			const bool listed = std::find(categories->begin(), categories->end(), category) != categories->end();
+			return listed != Excluded;
+		}
+	};
+
+	struct DescriptionPrefix
+	{
+		static constexpr bool readsDate = false;
+
+		std::string_view prefix;
+
+		bool operator()(const EventTable& table, std::size_t row) const
+		{
+			return table.description(row).starts_with(prefix);
+		}
+	};
+
+	struct Match
+	{
+		static constexpr bool readsDate = false;
+
+		const Regex* regex;
+
+		bool operator()(const EventTable& table, std::size_t row) const
+		{
+			return regex->search(table.description(row)) || regex->search(table.category(row));
+		}
+	};
+
+	enum class DateTest { Before, After, On, Between };
+
+	// A date comparison; `--today` is `On` with today's date.
+	template <DateTest Test>
+	struct Dates
+	{
+		static constexpr bool readsDate = true;
+
+		std::chrono::year_month_day first;
+		std::chrono::year_month_day last;
+
+		bool operator()(const EventTable& table, std::size_t row) const
+		{
+			const auto date = table.date(row);
+			if (!date.has_value())
+			{
+				return false;
+			}
+			if constexpr (Test == DateTest::Before)
+			{
+				return date.value() < first;
+			}
+			else if constexpr (Test == DateTest::After)
+			{
+				return date.value() > first;
+			}
+			else if constexpr (Test == DateTest::On)
+			{
+				return date.value() == first;
+			}
+			else
+			{
+				return date.value() >= first && date.value() <= last;
+			}
+		}
+	};
+
+	// Appends the rows in [first, last) that pass all `tests` to `rows`.
+	// Tests run in the given order and stop at the first that fails.
+	template <typename... Tests>
+	void scan(const EventTable& table, std::size_t first, std::size_t last,
+		std::vector<std::size_t>& rows, const Tests&... tests)
+	{
+		constexpr bool datesChecked = (Tests::readsDate || ...);
+		for (std::size_t row{ first }; row < last; row++)
+		{
+			if (table.erased(row) || !(tests(table, row) && ...))
+			{
+				continue;
+			}
+			if constexpr (!datesChecked)
+			{
+				if (!table.date(row).has_value())
+				{
+					continue;
+				}
+			}
+			rows.push_back(row);
+		}
+	}
+}
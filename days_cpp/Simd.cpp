@@ -0,0 +1,197 @@
+#include "Simd.h"
+
+#include <algorithm> // for std::min
+#include <bit>		 // for std::countr_zero
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DAYS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC compiles intrinsics for any instruction set without a target switch.
+#define DAYS_TARGET(isa)
+#else
+// GCC and Clang only accept AVX2 intrinsics in functions marked for that
+// target; the rest of the program stays baseline x86-64, which includes
+// SSE2. 32-bit x86 doesn't, so the SSE2 kernel is marked too.
+#define DAYS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace
+{
+	using RangeKernel = void (*)(const std::int32_t*, std::size_t, std::int32_t, std::int32_t, std::uint64_t*);
+
+	// One unsigned compare tests both bounds: values below `low` wrap around
+	// to large numbers.
+	void rangeScalar(const std::int32_t* values, std::size_t count, std::int32_t low, std::int32_t high, std::uint64_t* out)
+	{
+		const auto width = static_cast<std::uint32_t>(high) - static_cast<std::uint32_t>(low);
+		for (std::size_t word{ 0 }; word * 64 < count; word++)
+		{
+			const std::size_t base = word * 64;
+			const std::size_t n = std::min<std::size_t>(64, count - base);
+			std::uint64_t bits = 0;
+			for (std::size_t i{ 0 }; i < n; i++)
+			{
+				const bool inside = static_cast<std::uint32_t>(values[base + i]) - static_cast<std::uint32_t>(low) <= width;
+				bits |= static_cast<std::uint64_t>(inside) << i;
+			}
+			out[word] = bits;
+		}
+	}
+
+#ifdef DAYS_X86
+	DAYS_TARGET("avx2")
+	void rangeAvx2(const std::int32_t* values, std::size_t count, std::int32_t low, std::int32_t high, std::uint64_t* out)
+	{
+		const __m256i lowest = _mm256_set1_epi32(low);
+		const __m256i highest = _mm256_set1_epi32(high);
+		const std::size_t full = count / 64;
+		for (std::size_t word{ 0 }; word < full; word++)
+		{
+			std::uint64_t bits = 0;
+			for (std::size_t lane{ 0 }; lane < 64; lane += 8)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + word * 64 + lane));
+				const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lowest, v), _mm256_cmpgt_epi32(v, highest));
+				const auto mask = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(outside)));
+				bits |= static_cast<std::uint64_t>(~mask & 0xFFu) << lane;
+			}
+			out[word] = bits;
+		}
+		rangeScalar(values + full * 64, count - full * 64, low, high, out + full);
+	}
+
+	DAYS_TARGET("sse2")
+	void rangeSse2(const std::int32_t* values, std::size_t count, std::int32_t low, std::int32_t high, std::uint64_t* out)
+	{
+		const __m128i lowest = _mm_set1_epi32(low);
+		const __m128i highest = _mm_set1_epi32(high);
+		const std::size_t full = count / 64;
+		for (std::size_t word{ 0 }; word < full; word++)
+		{
+			std::uint64_t bits = 0;
+			for (std::size_t lane{ 0 }; lane < 64; lane += 4)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + word * 64 + lane));
+				const __m128i outside = _mm_or_si128(_mm_cmplt_epi32(v, lowest), _mm_cmpgt_epi32(v, highest));
+				const auto mask = static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(outside)));
+				bits |= static_cast<std::uint64_t>(~mask & 0xFu) << lane;
+			}
+			out[word] = bits;
+		}
+		rangeScalar(values + full * 64, count - full * 64, low, high, out + full);
+	}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	bool hasSse2()
+	{
+		int info[4];
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+	}
+
+	bool hasAvx2()
+	{
+		int info[4];
+		__cpuid(info, 1);
+		// The OS also has to save the YMM registers.
+		const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		return osAvx && (info[1] & (1 << 5)) != 0;
+	}
+#else
+	bool hasSse2()
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2");
+	}
+
+	bool hasAvx2()
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	}
+#endif
+#endif
+
+	struct Kernels
+	{
+		RangeKernel range;
+		const char* name;
+	};
+
+	const Kernels& kernels()
+	{
+		static const Kernels chosen = []
+		{
+#ifdef DAYS_X86
+			if (hasAvx2())
+			{
+				return Kernels{ rangeAvx2, "avx2" };
+			}
+			if (hasSse2())
+			{
+				return Kernels{ rangeSse2, "sse2" };
+			}
+#endif
+			return Kernels{ rangeScalar, "scalar" };
+		}();
+		return chosen;
+	}
+}
+
+namespace simd
+{
+	void selectRange(const std::int32_t* values, std::size_t count, std::int32_t low, std::int32_t high, Bitmap& out)
+	{
+		out.assign(wordsFor(count), 0);
+		if (low <= high)
+		{
+			kernels().range(values, count, low, high, out.data());
+		}
+	}
+
+	void andBits(Bitmap& target, const Bitmap& other)
+	{
+		for (std::size_t i{ 0 }; i < target.size(); i++)
+		{
+			target[i] &= other[i];
+		}
+	}
+
+	void orBits(Bitmap& target, const Bitmap& other)
+	{
+		for (std::size_t i{ 0 }; i < target.size(); i++)
+		{
+			target[i] |= other[i];
+		}
+	}
+
+	void andNotBits(Bitmap& target, const Bitmap& other)
+	{
+		for (std::size_t i{ 0 }; i < target.size(); i++)
+		{
+			target[i] &= ~other[i];
+		}
+	}
+
+	std::vector<std::size_t> setRows(const Bitmap& bits)
+	{
+		std::vector<std::size_t> rows;
+		for (std::size_t word{ 0 }; word < bits.size(); word++)
+		{
+			for (std::uint64_t rest = bits[word]; rest != 0; rest &= rest - 1)
+			{
+				rows.push_back(word * 64 + static_cast<std::size_t>(std::countr_zero(rest)));
+			}
+		}
+		return rows;
+	}
+
+	const char* instructionSet()
+	{
+		return kernels().name;
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Vectorized date filters over the dense columns of `EventTable`.
+//
+// A filter produces a match bitmap with one bit per row (bit `i % 64` of
+// word `i / 64`), and combined filters are computed by combining bitmaps.
+// The compares have an AVX2 version (8 rows per instruction), an SSE2
+// version (4 rows) and a scalar fallback; the best one the CPU supports is
+// picked on first use, so the same binary runs on any x86-64 machine and on
+// other architectures. The bitmap operations are plain loops over words,
+// which compilers vectorize on their own.
+namespace simd
+{
+	using Bitmap = std::vector<std::uint64_t>;
+
+	// Number of 64-bit words needed for `count` bits.
+	constexpr std::size_t wordsFor(std::size_t count)
+	{
+		return (count + 63) / 64;
+	}
+
+	// Sets `out` to the rows with `low <= values[i] <= high`.
+	void selectRange(const std::int32_t* values, std::size_t count, std::int32_t low, std::int32_t high, Bitmap& out);
+
+	// `target &= other`, `target |= other` and `target &= ~other`.
+	void andBits(Bitmap& target, const Bitmap& other);
+	void orBits(Bitmap& target, const Bitmap& other);
+	void andNotBits(Bitmap& target, const Bitmap& other);
+
+	// The rows whose bits are set, in increasing order.
+	std::vector<std::size_t> setRows(const Bitmap& bits);
+
+	// Name of the instruction set in use: "avx2", "sse2" or "scalar".
+	const char* instructionSet();
+}
@@ -0,0 +1,154 @@
+#include "Sort.h"
+
+#include <algorithm> // for ordering the category names
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>	 // for collecting the counts of the chunks
+#include <numeric>	 // for std::iota
+
+#include "Parallel.h"
+
+namespace
+{
+	constexpr std::size_t radixBits = 8;
+	constexpr std::size_t buckets = std::size_t{ 1 } << radixBits;
+
+	// Inputs with fewer rows than this per thread are sorted on fewer threads.
+	constexpr std::size_t rowsPerThread = 1 << 16;
+
+	using Counts = std::array<std::size_t, buckets>;
+
+	// Stable LSD radix sort of `rows` by `keys`, which are permuted alike.
+	//
+	// Each pass counts the digit of every key per chunk of rows and then
+	// moves each chunk's rows to the start of its bucket plus the rows of
+	// the same digit in earlier chunks. `parallelFor` splits the same count
+	// into the same chunks every time, so the two steps agree on them, and
+	// the order within a bucket stays the order of the input.
+	void radixSort(std::vector<std::uint32_t>& keys, std::vector<std::size_t>& rows)
+	{
+		const std::size_t count = keys.size();
+		std::uint32_t varying = 0;
+		for (std::uint32_t key : keys)
+		{
+			varying |= key ^ keys.front();
+		}
+
+		std::vector<std::uint32_t> sortedKeys(count);
+		std::vector<std::size_t> sortedRows(count);
+		for (std::size_t shift{ 0 }; shift < 32; shift += radixBits)
+		{
+			if (((varying >> shift) & (buckets - 1)) == 0)
+			{
+				continue; // every key has the same digit here
+			}
+
+			std::mutex lock;
+			std::map<std::size_t, Counts> chunks; // by first row of the chunk
+			parallelFor(count, rowsPerThread, [&](std::size_t begin, std::size_t end)
+				{
+					Counts counts{};
+					for (std::size_t i{ begin }; i < end; i++)
+					{
+						counts[(keys[i] >> shift) & (buckets - 1)]++;
+					}
+					std::lock_guard guard(lock);
+					chunks.emplace(begin, counts);
+				});
+
+			std::size_t offset = 0;
+			for (std::size_t digit{ 0 }; digit < buckets; digit++)
+			{
+				for (auto& [begin, counts] : chunks)
+				{
+					const std::size_t n = counts[digit];
+					counts[digit] = offset;
+					offset += n;
+				}
+			}
+
+			parallelFor(count, rowsPerThread, [&](std::size_t begin, std::size_t end)
+				{
+					Counts next = chunks.at(begin);
+					for (std::size_t i{ begin }; i < end; i++)
+					{
+						const std::size_t to = next[(keys[i] >> shift) & (buckets - 1)]++;
+						sortedKeys[to] = keys[i];
+						sortedRows[to] = rows[i];
+					}
+				});
+			keys.swap(sortedKeys);
+			rows.swap(sortedRows);
+		}
+	}
+
+	// Maps a signed day serial to an unsigned key with the same order.
+	std::uint32_t dayKey(std::int32_t serial)
+	{
+		return static_cast<std::uint32_t>(serial) ^ 0x80000000u;
+	}
+}
+
+std::optional<SortOrder> parseSortOrder(std::string_view name)
+{
+	if (name == "date")
+	{
+		return SortOrder::Date;
+	}
+	if (name == "-date")
+	{
+		return SortOrder::DateDescending;
+	}
+	if (name == "category")
+	{
+		return SortOrder::Category;
+	}
+	return std::nullopt;
+}
+
+void sortRows(const EventTable& table, std::vector<std::size_t>& rows, SortOrder order)
+{
+	if (rows.size() < 2)
+	{
+		return;
+	}
+
+	std::vector<std::uint32_t> keys(rows.size());
+	if (order == SortOrder::Category)
+	{
+		const auto& ids = table.categoryIds();
+		const auto& names = table.categoryNames();
+		std::vector<std::uint32_t> byName(names.size());
+		std::iota(byName.begin(), byName.end(), 0u);
+		std::sort(byName.begin(), byName.end(), [&](std::uint32_t a, std::uint32_t b) { return names[a] < names[b]; });
+		std::vector<std::uint32_t> rank(names.size());
+		for (std::size_t i{ 0 }; i < byName.size(); i++)
+		{
+			rank[byName[i]] = static_cast<std::uint32_t>(i);
+		}
+		for (std::size_t i{ 0 }; i < rows.size(); i++)
+		{
+			keys[i] = rank[ids[rows[i]]];
+		}
+	}
+	else
+	{
+		// Use the day column if it is already there; otherwise the dates of
+		// the rows, which the query has parsed.
+		const std::int32_t* serials = table.hasColumns() ? table.daySerials().data() : nullptr;
+		const bool descending = (order == SortOrder::DateDescending);
+		parallelFor(rows.size(), rowsPerThread, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i{ begin }; i < end; i++)
+				{
+					const std::int32_t serial = serials != nullptr
+						? serials[rows[i]]
+						: static_cast<std::int32_t>(std::chrono::sys_days{ table.date(rows[i]).value() }.time_since_epoch().count());
+					keys[i] = descending ? ~dayKey(serial) : dayKey(serial);
+				}
+			});
+	}
+	radixSort(keys, rows);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "EventTable.h"
+
+// Orders of `days list --sort`.
+enum class SortOrder
+{
+	Date,			// oldest first
+	DateDescending, // newest first, written `-date`
+	Category		// by category name
+};
+
+// Parses "date", "-date" or "category".
+std::optional<SortOrder> parseSortOrder(std::string_view name);
+
+// Sorts `rows` of `table`, which must all have a valid date, by `order`.
+//
+// The sort is stable, so events with the same date or category stay in file
+// order. It is an LSD radix sort on a 32-bit key per row: the day serial for
+// dates and the rank of the category name among all category names for
+// categories. Only the key bytes that differ between rows get a pass, so
+// dates within a few years take two passes over the rows. Large inputs are
+// counted and scattered on all cores.
+void sortRows(const EventTable& table, std::vector<std::size_t>& rows, SortOrder order);
@@ -0,0 +1,266 @@
+#include "TrigramIndex.h"
+
+#include <algorithm> // for sorting and set intersection
+#include <cstddef>	 // for offsetof
+#include <cstring>	 // for std::memcmp
+#include <fstream>	 // for reading and writing the index file
+#include <iterator>	 // for std::back_inserter
+
+#include "FileStamp.h"
+
+namespace
+{
+	constexpr char magic[8] = { 'D', 'A', 'Y', 'S', 'T', 'R', 'I', '1' };
+
+	struct Header
+	{
+		char magic[8];
+		FileStamp stamp; // of the events file the index belongs to
+		std::uint64_t rows;
+		std::uint64_t keys;
+	};
+
+	std::filesystem::path indexPathFor(const std::filesystem::path& eventsPath)
+	{
+		std::filesystem::path path = eventsPath;
+		path += ".trigrams";
+		return path;
+	}
+
+	bool readHeader(std::istream& input, Header& header)
+	{
+		input.read(reinterpret_cast<char*>(&header), sizeof(header));
+		return input && std::memcmp(header.magic, magic, sizeof(magic)) == 0;
+	}
+
+	std::uint32_t trigramAt(std::string_view text, std::size_t i)
+	{
+		return (static_cast<std::uint32_t>(static_cast<unsigned char>(text[i])) << 16)
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8)
+			| static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 2]));
+	}
+
+	// The distinct trigrams of `text`, sorted.
+	std::vector<std::uint32_t> trigramsOf(std::string_view text)
+	{
+		std::vector<std::uint32_t> trigrams;
+		for (std::size_t i{ 0 }; i + 3 <= text.size(); i++)
+		{
+			trigrams.push_back(trigramAt(text, i));
+		}
+		std::sort(trigrams.begin(), trigrams.end());
+		trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+		return trigrams;
+	}
+}
+
+TrigramIndex TrigramIndex::open(const EventTable& table, const std::filesystem::path& eventsPath)
+{
+	const auto indexPath = indexPathFor(eventsPath);
+
+	TrigramIndex index;
+	if (isCurrent(eventsPath) && index.read(indexPath))
+	{
+		// Appended rows are scanned; rebuild once they are a sizable share.
+		if (table.size() >= index.rows && table.size() - index.rows <= std::max<std::uint64_t>(4096, index.rows / 8))
+		{
+			return index;
+		}
+	}
+
+	index.build(table);
+	index.write(indexPath, eventsPath);
+	return index;
+}
+
+void TrigramIndex::build(const EventTable& table)
+{
+	// Collect (trigram, row) pairs packed into one integer each, so a plain
+	// sort groups them by trigram with rows in order inside each group.
+	std::vector<std::uint64_t> pairs;
+	for (std::size_t row{ 0 }; row < table.size(); row++)
+	{
+		for (std::uint32_t trigram : trigramsOf(table.description(row)))
+		{
+			pairs.push_back((static_cast<std::uint64_t>(trigram) << 32) | row);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+
+	rows = table.size();
+	keys.clear();
+	offsets.clear();
+	postings.clear();
+	postings.reserve(pairs.size());
+	for (std::uint64_t pair : pairs)
+	{
+		const auto trigram = static_cast<std::uint32_t>(pair >> 32);
+		if (keys.empty() || keys.back().trigram != trigram)
+		{
+			keys.push_back(Key{ trigram, 0 });
+			offsets.push_back(postings.size());
+		}
+		keys.back().count++;
+		postings.push_back(static_cast<std::uint32_t>(pair));
+	}
+}
+
+bool TrigramIndex::read(const std::filesystem::path& indexPath)
+{
+	// The file may be truncated or corrupt, so every size taken from it is
+	// checked against the file size before anything is allocated.
+	std::error_code error;
+	const std::uint64_t fileSize = std::filesystem::file_size(indexPath, error);
+	std::ifstream input(indexPath, std::ios::binary);
+	Header header{};
+	if (error || !readHeader(input, header))
+	{
+		return false;
+	}
+
+	std::uint64_t remaining = fileSize - sizeof(header);
+	if (header.keys > remaining / sizeof(Key))
+	{
+		return false;
+	}
+	rows = header.rows;
+	keys.resize(header.keys);
+	input.read(reinterpret_cast<char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(Key)));
+	if (!input)
+	{
+		return false;
+	}
+	remaining -= keys.size() * sizeof(Key);
+
+	offsets.resize(keys.size());
+	std::uint64_t total = 0;
+	for (std::size_t i{ 0 }; i < keys.size(); i++)
+	{
+		offsets[i] = total;
+		total += keys[i].count;
+	}
+	if (total != remaining / sizeof(std::uint32_t) || remaining % sizeof(std::uint32_t) != 0)
+	{
+		return false;
+	}
+	postings.resize(total);
+	input.read(reinterpret_cast<char*>(postings.data()), static_cast<std::streamsize>(postings.size() * sizeof(std::uint32_t)));
+	if (!input)
+	{
+		return false;
+	}
+	return std::all_of(postings.begin(), postings.end(), [&](std::uint32_t row) { return row < rows; });
+}
+
+bool TrigramIndex::write(const std::filesystem::path& indexPath, const std::filesystem::path& eventsPath) const
+{
+	Header header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.stamp = FileStamp::of(eventsPath);
+	header.rows = rows;
+	header.keys = keys.size();
+
+	std::filesystem::path tempPath = indexPath;
+	tempPath += ".tmp";
+	{
+		std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(Key)));
+		output.write(reinterpret_cast<const char*>(postings.data()), static_cast<std::streamsize>(postings.size() * sizeof(std::uint32_t)));
+		output.close();
+		if (!output)
+		{
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tempPath, indexPath, error);
+	return !error;
+}
+
+std::vector<std::size_t> TrigramIndex::search(const EventTable& table, std::string_view term) const
+{
+	std::vector<std::size_t> matches;
+	auto check = [&](std::size_t row)
+	{
+		if (!table.erased(row) && table.description(row).find(term) != std::string_view::npos)
+		{
+			matches.push_back(row);
+		}
+	};
+
+	const std::size_t indexed = std::min<std::size_t>(rows, table.size());
+	if (term.size() < 3)
+	{
+		// Too short to have a trigram: every row is a candidate.
+		for (std::size_t row{ 0 }; row < indexed; row++)
+		{
+			check(row);
+		}
+	}
+	else
+	{
+		// Look up the posting list of every trigram in the term, shortest first.
+		std::vector<std::pair<const std::uint32_t*, const std::uint32_t*>> lists;
+		for (std::uint32_t trigram : trigramsOf(term))
+		{
+			auto key = std::lower_bound(keys.begin(), keys.end(), trigram,
+				[](const Key& k, std::uint32_t value) { return k.trigram < value; });
+			if (key == keys.end() || key->trigram != trigram)
+			{
+				lists.clear();
+				break; // some trigram occurs nowhere, so the term can't either
+			}
+			const std::uint32_t* first = postings.data() + offsets[key - keys.begin()];
+			lists.emplace_back(first, first + key->count);
+		}
+		std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b)
+			{
+				return (a.second - a.first) < (b.second - b.first);
+			});
+
+		std::vector<std::uint32_t> candidates;
+		if (!lists.empty())
+		{
+			candidates.assign(lists[0].first, lists[0].second);
+		}
+		for (std::size_t i{ 1 }; i < lists.size() && !candidates.empty(); i++)
+		{
+			std::vector<std::uint32_t> narrowed;
+			std::set_intersection(candidates.begin(), candidates.end(), lists[i].first, lists[i].second, std::back_inserter(narrowed));
+			candidates.swap(narrowed);
+		}
+		for (std::uint32_t row : candidates)
+		{
+			check(row);
+		}
+	}
+
+	// Rows appended after the index was built.
+	for (std::size_t row{ indexed }; row < table.size(); row++)
+	{
+		check(row);
+	}
+	return matches;
+}
+
+bool TrigramIndex::isCurrent(const std::filesystem::path& eventsPath)
+{
+	std::ifstream input(indexPathFor(eventsPath), std::ios::binary);
+	Header header{};
+	return readHeader(input, header) && header.stamp == FileStamp::of(eventsPath);
+}
+
+void TrigramIndex::restamp(const std::filesystem::path& eventsPath)
+{
+	std::fstream file(indexPathFor(eventsPath), std::ios::binary | std::ios::in | std::ios::out);
+	const FileStamp stamp = FileStamp::of(eventsPath);
+	file.seekp(offsetof(Header, stamp));
+	file.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+}
+
+void TrigramIndex::invalidate(const std::filesystem::path& eventsPath)
+{
+	std::error_code error;
+	std::filesystem::remove(indexPathFor(eventsPath), error);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "EventTable.h"
+
+// Trigram inverted index over event descriptions for substring search.
+//
+// Every run of three bytes in a description is a trigram; the index maps
+// each trigram to the sorted list of rows containing it. A search for a term
+// intersects the lists of the term's trigrams, and only the surviving
+// candidate rows are checked with a real substring comparison.
+//
+// The index is persisted next to the events file (`events.csv.trigrams`),
+// stamped with the size and modification time of the file it was built from.
+// Appending events keeps it usable: `restamp()` updates the stamp, and rows
+// past the indexed ones are simply scanned until there are enough of them
+// to make a rebuild worthwhile. Rewriting the events file (deleting events)
+// must `invalidate()` the index; it is rebuilt on the next search.
+class TrigramIndex
+{
+public:
+	// Loads the stored index for `eventsPath` if it is current, otherwise
+	// builds one from `table` and stores it.
+	static TrigramIndex open(const EventTable& table, const std::filesystem::path& eventsPath);
+
+	// Rows whose description contains `term`, in file order.
+	std::vector<std::size_t> search(const EventTable& table, std::string_view term) const;
+
+	// Returns true if the stored index matches the events file as it is now.
+	static bool isCurrent(const std::filesystem::path& eventsPath);
+
+	// Records the events file as it is now in the stored index. Only call
+	// this if the index was current before events were appended.
+	static void restamp(const std::filesystem::path& eventsPath);
+
+	// Removes the stored index.
+	static void invalidate(const std::filesystem::path& eventsPath);
+
+private:
+	struct Key
+	{
+		std::uint32_t trigram;
+		std::uint32_t count;
+	};
+
+	void build(const EventTable& table);
+	bool read(const std::filesystem::path& indexPath);
+	bool write(const std::filesystem::path& indexPath, const std::filesystem::path& eventsPath) const;
+
+	std::uint64_t rows{ 0 };
+	std::vector<Key> keys;				 // sorted by trigram
+	std::vector<std::uint64_t> offsets;	 // start of each key's rows in `postings`
+	std::vector<std::uint32_t> postings; // rows, sorted per trigram
+};
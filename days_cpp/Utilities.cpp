@@ -13,6 +13,8 @@
 #include <string_view> // for std::string_view
 #include <filesystem>  // for path utilities
 #include <memory>	   // for smart pointers
+#include <cstdint>	   // for fixed width integers
+#include <cstring>	   // for std::memcpy
 
 #include <vector>
 #include <algorithm>
@@ -102,6 +104,43 @@ std::optional<std::chrono::year_month_day> Utilities::getDateFromString(const st
 	return nullopt;
 }
 
+// Fast path for strict `YYYY-MM-DD` dates, used when loading and importing
+// large files. All eight digits are checked at once by packing them into one
+// 64-bit word: a byte is a digit if its high nibble is 3 and adding 6 to it
+// doesn't carry out of the low nibble. No allocation, no exceptions.
+// Returns `std::nullopt` for anything else, including non-canonical forms
+// that `getDateFromString` would still accept.
+std::optional<std::chrono::year_month_day> Utilities::parseIsoDate(std::string_view buf)
+{
+	if (buf.size() != 10 || buf[4] != '-' || buf[7] != '-')
+	{
+		return std::nullopt;
+	}
+
+	const char digits[8] = { buf[0], buf[1], buf[2], buf[3], buf[5], buf[6], buf[8], buf[9] };
+	std::uint64_t word;
+	std::memcpy(&word, digits, sizeof(word));
+	constexpr std::uint64_t highNibbles = 0xF0F0F0F0F0F0F0F0ull;
+	constexpr std::uint64_t threes = 0x3030303030303030ull;
+	constexpr std::uint64_t sixes = 0x0606060606060606ull;
+	if ((word & highNibbles) != threes || ((word + sixes) & highNibbles) != threes)
+	{
+		return std::nullopt;
+	}
+
+	auto digit = [&](int i) { return digits[i] - '0'; };
+	const int year = digit(0) * 1000 + digit(1) * 100 + digit(2) * 10 + digit(3);
+	const unsigned month = static_cast<unsigned>(digit(4) * 10 + digit(5));
+	const unsigned day = static_cast<unsigned>(digit(6) * 10 + digit(7));
+
+	const std::chrono::year_month_day result{ std::chrono::year{ year }, std::chrono::month{ month }, std::chrono::day{ day } };
+	if (!result.ok())
+	{
+		return std::nullopt;
+	}
+	return result;
+}
+
 // Returns `date` as a string in `YYYY-MM-DD` format.
 // The ostream support for `std::chrono::year_month_day` is not
 // available in most (any?) compilers, so we roll our own.
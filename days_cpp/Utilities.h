@@ -2,6 +2,7 @@
 #include <optional>
 #include <string>
 #include <chrono>
+#include <string_view>
 
 class Utilities
 {
@@ -10,6 +11,7 @@ public:
 	void display(const T& value);
 	void newline();
 	std::optional<std::chrono::year_month_day> getDateFromString(const std::string& buf);
+	std::optional<std::chrono::year_month_day> parseIsoDate(std::string_view buf);
 	std::string getStringFromDate(const std::chrono::year_month_day& date);
 	std::optional<std::string> getEnvironmentVariable(const std::string& name);
 	void print_birthday(auto currentDate);
@@ -19,9 +19,19 @@
 #include <vector>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 
 #include "Event.h"	  // for our Event class
-#include "rapidcsv.h" // for the header-only library RapidCSV
+#include "EventTable.h" // for lazily loading the events file
+#include "Query.h"	   // for batch queries
+#include "Import.h"	   // for bulk imports
+#include "Dedupe.h"	   // for finding duplicate events
+#include "DescriptionIndex.h" // for description prefix lookups
+#include "TrigramIndex.h" // for substring search
+#include "Fuzzy.h"	   // for approximate search
+#include "Regex.h"	   // for --match
+#include "Sort.h"	   // for list --sort
+#include "ExternalSort.h" // for list --memory-budget
 #include "Utilities.h"
 
 
@@ -47,7 +57,7 @@ std::ostream &operator<<(std::ostream &os, const Event &event)
 	os
 		<< tools.getStringFromDate(event.getTimestamp()) << ": "
 		<< event.getDescription()
-		<< " (" + event.getCategory() + ")";
+		<< " (" << event.getCategory() << ")";
 	return os;
 }
 
@@ -57,30 +67,6 @@ int getNumberOfDaysBetween(std::chrono::sys_days const &earlier, std::chrono::sy
 	return (later - earlier).count();
 }
 
-std::vector<std::string> remove_commas(std::string args)
-{
-	std::vector<std::string> separated_args;
-	size_t pos = args.find(",");
-
-	while (pos != std::string::npos)
-	{
-		// Get the substring from the beginning to the comma
-		std::string sub = args.substr(0, pos);
-
-		separated_args.push_back(sub);
-
-		// Erase the substring and the comma from the original string
-		args.erase(0, pos + 1);
-
-		// Find the next comma
-		pos = args.find(',');
-	}
-
-	// Add the remaining string to the vector
-	separated_args.push_back(args);
-	return separated_args;
-}
-
 void print_day_format(int delta, auto event)
 {
 	std::ostringstream line;
@@ -101,48 +87,290 @@ void print_day_format(int delta, auto event)
 	newline();
 }
 
-// This functions works by copying the events.csv file to a events.csv.tmp file,
-// then deleting the events.csv file and renaming the temp file to events.csv!
-void update_csv_file(auto& eventsPath, auto& tempPath, char *argv[], Event& event)
+// Removes every `flag` from `words` and returns true if there was one.
+bool take_flag(std::vector<std::string>& words, const std::string& flag)
+{
+	auto end = std::remove(words.begin(), words.end(), flag);
+	const bool found = end != words.end();
+	words.erase(end, words.end());
+	return found;
+}
+
+// Removes `option` and the value after it from `words`. Returns the value,
+// or an empty string if `option` is last; `std::nullopt` if it is missing.
+std::optional<std::string> take_option(std::vector<std::string>& words, const std::string& option)
 {
-	try {
-		namespace fs = std::filesystem; // save a little typing
-		using std::string;
-		std::stringstream ss;
-		ss << event.getTimestamp() << "," << event.getCategory() << "," << event.getDescription();
-		std::string event_formatted = ss.str(); // get the string from the stringstream
-
-		string deleteline = event_formatted;
-		string line;
-		string newline;
-
-		// events file
-		std::ifstream fin;
-		fin.open(eventsPath.string());
-
-		// temp file
-		std::ofstream temp;
-		temp.open(tempPath.string());
-
-		while (std::getline(fin, line)) {
-			if (line.find(deleteline) == std::string::npos) {
-				temp << line << "\n";
+	auto found = std::find(words.begin(), words.end(), option);
+	if (found == words.end())
+	{
+		return std::nullopt;
+	}
+	std::string value;
+	auto end = found + 1;
+	if (end != words.end())
+	{
+		value = *end++;
+	}
+	words.erase(found, end);
+	return value;
+}
+
+// Removes `--sort ORDER` from `words` and sets `order` from it, if given.
+// Prints a message and returns false if the order is missing or unknown.
+bool take_sort_order(std::vector<std::string>& words, std::optional<SortOrder>& order)
+{
+	auto name = take_option(words, "--sort");
+	if (!name.has_value())
+	{
+		return true;
+	}
+	order = parseSortOrder(name.value());
+	if (!order.has_value())
+	{
+		std::cout << (name->empty() ? "No sort order given" : "bad sort order: " + name.value()) << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Runs `list` or `delete` with the filter options in `words`. Both commands
+// execute the same query plan. `list ... --count` only prints the number of
+// matches, `list ... --sort ORDER` prints them by date, `-date` or category
+// instead of in file order, and `delete ... --dry-run` only shows what would
+// be deleted.
+// Deleted rows are erased from `table`; writing the table back is left to
+// the caller. If `index` is given, a description prefix is looked up in it,
+// and it is (re)built when it doesn't cover the table. With `eventsPath`,
+// the index is the one stored next to the events file instead; see
+// `DescriptionIndex`.
+// Returns true if rows were erased.
+bool run_query_command(const std::string& command, std::vector<std::string> words, EventTable& table,
+	std::chrono::sys_days today, std::unique_ptr<DescriptionIndex>* index,
+	const std::filesystem::path* eventsPath = nullptr)
+{
+	using std::cout;
+	const bool deleting = (command == "delete");
+	const bool count_only = !deleting && take_flag(words, "--count");
+	const bool dry_run = deleting && take_flag(words, "--dry-run");
+	std::optional<SortOrder> order;
+	if (!deleting && !take_sort_order(words, order))
+	{
+		return false;
+	}
+	if (deleting && words.empty())
+	{
+		// Deleting everything needs an explicit `--all`.
+		cout << "No date given or wrong formatting" << '\n';
+		return false;
+	}
+
+	std::string error;
+	auto query = Query::parse(words, error);
+	if (!query.has_value())
+	{
+		cout << error << '\n';
+		return false;
+	}
+
+	const DescriptionIndex* lookup = nullptr;
+	if (index != nullptr && query->usesDescriptionIndex())
+	{
+		if (eventsPath != nullptr)
+		{
+			// A delete rewrites the file, which invalidates the index right
+			// away, so it only uses one that is already stored and otherwise
+			// scans rather than pay for a sort.
+			*index = deleting ? DescriptionIndex::load(table, *eventsPath) : DescriptionIndex::open(table, *eventsPath);
+		}
+		else if (!*index || !(*index)->covers(table))
+		{
+			*index = std::make_unique<DescriptionIndex>(table);
+		}
+		lookup = index->get();
+	}
+
+	auto rows = query->execute(table, today, lookup);
+	if (order.has_value() && !count_only)
+	{
+		sortRows(table, rows, order.value());
+	}
+	for (size_t row : rows)
+	{
+		if (!deleting)
+		{
+			if (!count_only)
+			{
+				const auto delta = (std::chrono::sys_days{ table.date(row).value() } - today).count();
+				print_day_format(delta, table.event(row));
 			}
 		}
+		else if (dry_run)
+		{
+			cout << table.event(row) << " would have been deleted without dry run" << '\n';
+		}
+		else
+		{
+			cout << "Deleted event " << table.event(row) << '\n';
+			table.erase(row);
+		}
+	}
 
-		temp.close();
-		fin.close();
+	if (count_only)
+	{
+		cout << rows.size() << " events" << '\n';
+	}
+	else if (rows.empty())
+	{
+		cout << "No events found" << '\n';
+	}
+	else if (deleting && !dry_run && std::find(words.begin(), words.end(), "--all") != words.end())
+	{
+		cout << "Deleted all events" << '\n';
+	}
+	return deleting && !dry_run && !rows.empty();
+}
 
-		// delete events file and rename temp file to events file
-		fs::remove(eventsPath.string().c_str());
-		fs::rename(tempPath.string().c_str(), eventsPath.string().c_str());
+// Runs `list` without loading the events file; see `listExternally()`.
+// Takes the same options as `list`. Without `--memory-budget SIZE` the
+// file is streamed with `streamingBudget`.
+// Returns the exit code for `main()`.
+int run_external_list(std::vector<std::string> words, const std::filesystem::path& eventsPath, std::chrono::sys_days today)
+{
+	using std::cout;
+	const bool count_only = take_flag(words, "--count");
+	std::optional<SortOrder> order;
+	if (!take_sort_order(words, order))
+	{
+		return 0;
+	}
+	std::optional<std::size_t> budget = streamingBudget;
+	if (auto budget_text = take_option(words, "--memory-budget"); budget_text.has_value())
+	{
+		budget = parseMemoryBudget(budget_text.value());
+		if (!budget.has_value())
+		{
+			cout << (budget_text->empty() ? "No memory budget given" : "bad memory budget: " + budget_text.value()) << '\n';
+			return 0;
+		}
+	}
 
-		std::cout << "Deleted event " << event << std::endl;
+	std::string error;
+	auto query = Query::parse(words, error);
+	if (!query.has_value())
+	{
+		cout << error << '\n';
+		return 0;
 	}
-	catch (const std::exception&)
+
+	// Sorting happens before any output, so only the order is needed here.
+	auto found = listExternally(eventsPath, query.value(), count_only ? std::nullopt : order, budget.value(), today,
+		[&](const Event& event)
+		{
+			if (!count_only)
+			{
+				const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
+				print_day_format(delta, event);
+			}
+		});
+	if (!found.has_value())
+	{
+		return 1;
+	}
+
+	if (count_only)
+	{
+		cout << found.value() << " events" << '\n';
+	}
+	else if (found.value() == 0)
 	{
-		std::cout << "An error occured while writing to file." << std::endl;
+		cout << "No events found" << '\n';
 	}
+	return 0;
+}
+
+// Runs `days` commands read from `input`, one per line and without the
+// leading `days`, for example `add --date 2024-01-01 --description "New year"`.
+// All commands work on the same in-memory `table`. Additions and deletions
+// are group-committed: the events file is rewritten once, atomically, after
+// the last command instead of being reopened by every command.
+int run_batch(std::istream& input, EventTable& table, const std::filesystem::path& eventsPath, std::chrono::sys_days today)
+{
+	using std::cout, std::string, std::vector;
+	Utilities tools;
+
+	// Built on the first prefix query and rebuilt after rows were added.
+	std::unique_ptr<DescriptionIndex> index;
+
+	bool modified = false;
+	string line;
+	while (std::getline(input, line))
+	{
+		vector<string> words = splitWords(line);
+		if (words.empty() || words[0].starts_with("#"))
+		{
+			continue;
+		}
+
+		const string command = words[0];
+		words.erase(words.begin());
+
+		// Returns the value following `option`, if any.
+		auto option_value = [&](const string& option) -> std::optional<string>
+		{
+			for (size_t i{ 0 }; i + 1 < words.size(); i++)
+			{
+				if (words[i] == option)
+				{
+					return words[i + 1];
+				}
+			}
+			return std::nullopt;
+		};
+
+		if (command == "add")
+		{
+			std::optional<std::chrono::year_month_day> date = std::chrono::year_month_day{ today };
+			if (auto date_string = option_value("--date"))
+			{
+				date = tools.getDateFromString(date_string.value());
+			}
+			if (!date.has_value())
+			{
+				std::cerr << "bad date: " << option_value("--date").value() << '\n';
+				continue;
+			}
+			table.append(date.value(), option_value("--category").value_or(""), option_value("--description").value_or(""));
+			cout << "Successfully added event " << table.event(table.size() - 1) << '\n';
+			modified = true;
+			continue;
+		}
+
+		if (command == "list" || command == "delete")
+		{
+			// The table answers many queries, so dense columns pay off.
+			table.buildColumns();
+			if (run_query_command(command, words, table, today, &index))
+			{
+				modified = true;
+			}
+		}
+		else
+		{
+			cout << "Unknown command: " << command << '\n';
+		}
+	}
+
+	if (modified && !table.save(eventsPath))
+	{
+		std::cerr << "An error occured while writing to file." << '\n';
+		return 1;
+	}
+	if (modified)
+	{
+		TrigramIndex::invalidate(eventsPath);
+		DescriptionIndex::invalidate(eventsPath);
+	}
+	return 0;
 }
 
 int main(int argc, char* argv[])
@@ -196,36 +424,54 @@ int main(int argc, char* argv[])
 	// Now we should have a valid path to the `~/.days` directory.
 	// Construct a pathname for the `events.csv` file.
 	auto eventsPath = daysPath / "events.csv";
-	auto tempPath = daysPath / "events.csv.tmp";
 
-	//
-	// Read in the CSV file from `eventsPath` using RapidCSV
-	// See https://github.com/d99kris/rapidcsv
-	//
-	rapidcsv::Document document{ eventsPath.string() };
-	vector<string> dateStrings{ document.GetColumn<string>("date") };
-	vector<string> categoryStrings{ document.GetColumn<string>("category") };
-	vector<string> descriptionStrings{ document.GetColumn<string>("description") };
-
-	vector<Event> events;
-
-	for (size_t i{ 0 }; i < dateStrings.size(); i++)
+	// `days import` appends to the file without loading it first.
+	string arg_import = "import";
+	if (argc > 1 && argv[1] == arg_import)
 	{
-		auto date = tools.getDateFromString(dateStrings.at(i));
-		if (!date.has_value())
+		ImportOptions options;
+		string error;
+		if (!parseImportOptions(vector<string>(argv + 2, argv + argc), options, error))
 		{
-			std::cerr << "bad date at row " << i << ": " << dateStrings.at(i) << '\n';
-			continue;
+			std::cerr << error << endl;
+			return 1;
 		}
+		return importEvents(options, eventsPath);
+	}
 
-		Event event{
-			date.value(),
-			categoryStrings.at(i),
-			descriptionStrings.at(i) };
-		events.push_back(event);
+	// `days list` needs nothing but the filter, so it streams the file in
+	// fixed-size chunks and prints the matches of each chunk as it goes; its
+	// memory use doesn't grow with the file. `--sort` needs every match
+	// first and loads the file, unless `--memory-budget SIZE` is given.
+	string arg_list = "list";
+	string arg_sort = "--sort";
+	string arg_memory_budget = "--memory-budget";
+	auto has_option = [&](const string& option) { return std::find(argv + 2, argv + argc, option) != argv + argc; };
+	if (argc > 1 && argv[1] == arg_list && (!has_option(arg_sort) || has_option(arg_memory_budget)))
+	{
+		return run_external_list(vector<string>(argv + 2, argv + argc), eventsPath, std::chrono::sys_days{ currentDate });
+	}
+
+	//
+	// Index the CSV file at `eventsPath`. Columns are materialized lazily,
+	// so a query only pays for parsing the fields it actually looks at.
+	//
+	EventTable table;
+	if (!table.load(eventsPath))
+	{
+		std::cerr << "Unable to read " << eventsPath.string() << endl;
+		return 1;
+	}
+
+	// Script mode: `days batch < commands.txt` runs many add/delete/list
+	// commands against one loaded table and writes the file back once.
+	string arg_batch = "batch";
+	if (argc > 1 && argv[1] == arg_batch)
+	{
+		return run_batch(std::cin, table, eventsPath, std::chrono::sys_days{ currentDate });
 	}
 
-	if (events.size() == 0)
+	if (table.size() == 0)
 	{
 		cout << "No events found" << endl;
 		return 0;
@@ -236,14 +482,8 @@ int main(int argc, char* argv[])
 
 
 	// Command line arguments
-	string arg_list = "list";
-	string arg_today = "--today";
-	string arg_before = "--before-date";
-	string arg_after = "--after-date";
+	string arg_delete = "delete";
 	string arg_date = "--date";
-	string arg_categories = "--categories";
-	string arg_exclude = "--exclude";
-	string arg_no_category = "--no-category";
 
 	// Counter for printing not found
 	int count = 0;
@@ -255,156 +495,120 @@ int main(int argc, char* argv[])
 		return 0;
 	}
 
-	// if first argument is list
-	if (argv[1] == arg_list)
+	// Batch query mode: `days query [FILE]` reads one `list` filter per line
+	// from FILE or standard input and answers all of them in a single scan.
+	string arg_query = "query";
+	if (argv[1] == arg_query)
 	{
-		// if only list argument, print all events
-		if (argc == 2)
+		vector<QuerySpec> specs;
+		if (argc > 2)
 		{
-			for (auto& event : events)
+			std::ifstream input(argv[2]);
+			if (!input)
 			{
-				const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-				print_day_format(delta, event);
+				std::cerr << "Unable to read " << argv[2] << endl;
+				return 1;
 			}
-			return 0;
+			specs = readQuerySpecs(input);
 		}
-
-		// if argument after list is today, print today's events
-		if (argv[2] == arg_today && argc == 3)
+		else
 		{
-			for (auto& event : events)
-			{
-				const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-				if (delta == 0)
-				{
-					print_day_format(delta, event);
-					count++;
-				}
-			}
+			specs = readQuerySpecs(std::cin);
 		}
 
-		// List events by before, after or both. Also list events on a specific date
-		if (argc > 2 && (argv[2] == arg_before || argv[2] == arg_after || argv[2] == arg_date))
+		const auto results = evaluateQueries(table, specs, today);
+		for (size_t i{ 0 }; i < specs.size(); i++)
 		{
-			if (argc < 4)
+			if (i > 0)
 			{
-				cout << "No date given" << endl;
-				return 0;
+				newline();
 			}
-
-			bool before = false;
-			bool after = false;
-			bool on_this_date = false;
-			auto date1 = tools.getDateFromString(argv[3]);
-			auto date2 = tools.getDateFromString(argv[3]);
-
-			if (argv[2] == arg_before)
+			cout << "== " << specs[i].text << endl;
+			if (!specs[i].query.has_value())
 			{
-				before = true;
+				cout << specs[i].error << endl;
+				continue;
 			}
-
-			if (argv[2] == arg_after)
+			if (results[i].empty())
 			{
-				after = true;
+				cout << "No events found" << endl;
 			}
-
-			if (argc > 4 && argv[2] == arg_before && argv[4] == arg_after)
+			for (size_t row : results[i])
 			{
-				before = true;
-				after = true;
-				date1 = tools.getDateFromString(argv[3]);
-				date2 = tools.getDateFromString(argv[5]);
+				const auto delta = (std::chrono::sys_days{ table.date(row).value() } - today).count();
+				print_day_format(delta, table.event(row));
 			}
+		}
+		return 0;
+	}
 
-			if (argv[2] == arg_date)
-			{
-				on_this_date = true;
-			}
+	// `days list` and `days delete` take the same filter options, which can
+	// be combined freely; see `Query`. `--description` and
+	// `--description-prefix` are looked up in the description index stored
+	// next to the events file.
+	if (argv[1] == arg_list || argv[1] == arg_delete)
+	{
+		std::unique_ptr<DescriptionIndex> index;
+		if (!run_query_command(argv[1], vector<string>(argv + 2, argv + argc), table, today, &index, &eventsPath))
+		{
+			return 0;
+		}
+		if (!table.save(eventsPath))
+		{
+			std::cout << "An error occured while writing to file." << endl;
+			return 1;
+		}
+		TrigramIndex::invalidate(eventsPath);
+		DescriptionIndex::invalidate(eventsPath);
+		return 0;
+	}
 
-			for (auto& event : events)
-			{
-				const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-				if (before)
-				{
-					if (event.getTimestamp() < date1)
-					{
-						print_day_format(delta, event);
-						count++;
-					}
-				}
-				if (after)
-				{
-					if (event.getTimestamp() > date2)
-					{
-						print_day_format(delta, event);
-						count++;
-					}
-				}
-				if (on_this_date)
-				{
-					if (event.getTimestamp() == date1)
-					{
-						print_day_format(delta, event);
-						count++;
-					}
-				}
-			}
+	// `days search TERM` lists events whose description contains TERM,
+	// using the trigram index stored next to the events file.
+	// `days search --fuzzy K TERM` allows up to K typos and ranks the
+	// matches by their number of edits.
+	string arg_search = "search";
+	string arg_fuzzy = "--fuzzy";
+	if (argv[1] == arg_search)
+	{
+		bool fuzzy = (argc > 2 && argv[2] == arg_fuzzy);
+		if (argc < (fuzzy ? 5 : 3))
+		{
+			cout << "No search term given" << endl;
+			return 0;
 		}
 
-		// Categories
-		// if argument after list is --categories
-		if (argv[2] == arg_categories)
+		vector<size_t> rows;
+		if (fuzzy)
 		{
-			if (argc < 4)
+			int max_distance = -1;
+			try
 			{
-				cout << "No category given" << endl;
-				return 0;
+				max_distance = std::stoi(argv[3]);
 			}
-
-			// Put categories to vector and remove commas
-			std::vector arg_categories = remove_commas(argv[3]);
-
-			// Exclude events with given categories, check if --exclude is given
-			bool exclude = exclude = (argc > 4 && argv[4] == arg_exclude);
-			// Events with no category
-			bool no_category = false;
-
-			for (auto& event : events)
+			catch (const std::exception&)
 			{
-				if (exclude)
-				{
-					// If the event category is not in the arg_categories vector, then print it
-					if (std::find(arg_categories.begin(), arg_categories.end(), event.getCategory()) == arg_categories.end())
-					{
-						const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-						print_day_format(delta, event);
-						count++;
-					}
-				}
-				else
-				{
-					// If the event category is in the arg_categories vector, then print it
-					if (std::find(arg_categories.begin(), arg_categories.end(), event.getCategory()) != arg_categories.end())
-					{
-						const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-						print_day_format(delta, event);
-						count++;
-					}
-				}
 			}
+			if (max_distance < 0)
+			{
+				std::cerr << "bad edit distance: " << argv[3] << '\n';
+				return 0;
+			}
+			rows = fuzzySearch(table, argv[4], max_distance);
+		}
+		else
+		{
+			rows = TrigramIndex::open(table, eventsPath).search(table, argv[2]);
 		}
 
-		// if argument after list is --no-category
-		if (argc == 3 && argv[2] == arg_no_category)
+		for (size_t row : rows)
 		{
-			for (auto& event : events)
+			auto date = table.date(row);
+			if (date.has_value())
 			{
-				if (event.getCategory() == "")
-				{
-					const auto delta = (std::chrono::sys_days{ event.getTimestamp() } - today).count();
-					print_day_format(delta, event);
-					count++;
-				}
+				const auto delta = (std::chrono::sys_days{ date.value() } - today).count();
+				print_day_format(delta, table.event(row));
+				count++;
 			}
 		}
 	}
@@ -455,22 +659,30 @@ int main(int argc, char* argv[])
 			}
 		}
 
-		// Push to event vector, not really necessary since the program will end after this
 		Event event(date.value(), category, description);
-		events.push_back(event);
 
-		// Build string that has formatted event for the .csv file
-		std::stringstream ss;
-		ss << event.getTimestamp() << "," << event.getCategory() << "," << event.getDescription();
-		std::string event_formatted = ss.str(); // get the string from the stringstream
+		// Build the line for the .csv file, quoted the same way as batch adds
+		std::string event_formatted;
+		appendCsvRow(event_formatted, tools.getStringFromDate(event.getTimestamp()), event.getCategory(), event.getDescription());
 
 		// Write to events.csv in events path
 		try
 		{
+			// Appending keeps the search indexes valid if they were before.
+			bool index_current = TrigramIndex::isCurrent(eventsPath);
+			bool descriptions_current = DescriptionIndex::isCurrent(eventsPath);
 			ofstream file;
-			file.open(eventsPath.string(), std::ios::out | std::ios::app);
-			file << event_formatted << endl;
+			file.open(eventsPath.string(), std::ios::out | std::ios::app | std::ios::binary);
+			file << event_formatted;
 			file.close();
+			if (index_current)
+			{
+				TrigramIndex::restamp(eventsPath);
+			}
+			if (descriptions_current)
+			{
+				DescriptionIndex::restamp(eventsPath);
+			}
 			std::cout << "Successfully added event " << event << std::endl;
 			count++;
 		}
@@ -481,202 +693,36 @@ int main(int argc, char* argv[])
 		
 	}
 
-	// Arguments for deleting events
-	string arg_delete = "delete";
-	string arg_all = "--all";
 	string arg_dry_run = "--dry-run";
 
-	// If delete is given as first argument after days
-	if (argv[1] == arg_delete)
+	// `days dedupe [--dry-run]` removes exact duplicate events, keeping the
+	// first occurrence of each, and rewrites the file once.
+	string arg_dedupe = "dedupe";
+	if (argv[1] == arg_dedupe)
 	{
-
-		if (argc < 3)
-		{
-			std::cout << "No date given or wrong formatting" << endl;
-			return 0;
-		}
-
-		int length = argc - 1;
-
-		// If --description or --category is given as first argument after delete
-		if (argc > 2 && (argv[2] == arg_description || argv[2] == arg_category))
+		bool dry_run = (argc > 2 && argv[2] == arg_dry_run);
+		for (size_t row : findDuplicates(table))
 		{
-			bool is_description = (argv[2] == arg_description);
-			for (auto& event : events)
+			if (dry_run)
 			{
-				if ((is_description && event.getDescription().starts_with(argv[3]) && argv[length] == arg_dry_run)
-					|| (!is_description && event.getCategory() == argv[3] && argv[length] == arg_dry_run))
-				{
-					std::cout <<  event << " would have been deleted without dry run" << endl;
-					count++;
-				}
-
-				if ((is_description && event.getDescription().starts_with(argv[3]) && argv[length] != arg_dry_run)
-					|| (!is_description && event.getCategory() == argv[3] && argv[length] != arg_dry_run))
-				{
-					update_csv_file(eventsPath, tempPath, argv, event);
-					count++;
-				}
-			}
-		}
-
-		// If --date is given as first argument after delete
-		if (argv[2] == arg_date)
-		{
-			auto date = tools.getDateFromString(argv[3]);
-			if (!date.has_value())	
-			{
-				std::cerr << "bad date: " << argv[3] << '\n';
-				return 0;
+				std::cout << table.event(row) << " would have been deleted without dry run" << endl;
 			}
-		
-			// Check if arguments have --category and --description
-			bool has_category = (argc > 5 && argv[4] == arg_category);
-			bool has_description = (argc > 6 && argv[6] == arg_description);
-
-			if (has_category)
+			else
 			{
-				for (int i = 2; i < argc; i++)
-				{
-					if (argv[i] == arg_category)
-					{
-						category = argv[i + 1];
-					}
-					if (argv[i] == arg_description)
-					{
-						description = argv[i + 1];
-					}
-				}
-			}
-
-			for (auto& event : events)
-			{
-				// If category is given, find events with given date and category
-				if (has_category)
-				{
-					// If description is not given, find events with given date and category
-					if (!has_description)
-					{
-						// Find events with given date and category. If --dry-run is given, print out the events that would have been deleted
-						if (event.getTimestamp() == date.value() && event.getCategory() == category && argv[length] == arg_dry_run)
-						{
-							std::cout << event << " would have been deleted without dry run" << endl;
-							count++;
-						}
-
-						// If --dry-run is not given, update the csv file
-						if (event.getTimestamp() == date.value() && event.getCategory() == category && argv[length] != arg_dry_run)
-						{
-							update_csv_file(eventsPath, tempPath, argv, event);
-							count++;
-						}
-					}
-					// If description is given, find events with given date, category and description
-					if (has_description)
-					{
-						// Same as above, but also checks if event description starts with given description
-						if (event.getTimestamp() == date.value() && event.getCategory() == category &&
-							event.getDescription().starts_with(description) && argv[length] == arg_dry_run)
-						{
-							std::cout << event << " would have been deleted without dry run" << endl;
-							count++;
-						}
-
-						// If --dry-run is not given, update the csv file
-						if (event.getTimestamp() == date.value() && event.getCategory() == category &&
-							event.getDescription().starts_with(description) && argv[length] != arg_dry_run)
-						{
-							update_csv_file(eventsPath, tempPath, argv, event);
-							count++;
-						}
-					}
-				}
-
-				// If category is not given, find events just with given date
-				if (!has_category)
-				{
-					if (event.getTimestamp() == date.value() && argv[length] == arg_dry_run)
-					{
-						std::cout << event << " would have been deleted without dry run" << endl;
-						count++;
-					}
-
-					if (event.getTimestamp() == date.value() && argv[length] != arg_dry_run)
-					{
-						update_csv_file(eventsPath, tempPath, argv, event);
-						count++;
-					}
-				}
-			}	
-		}
-
-		// If --all is given as argument after delete
-		if (argv[2] == arg_all)
-		{
-			// If --dry-run is given, just print what would have been deleted
-			if (argc > 3 && argv[3] == arg_dry_run)
-			{
-				for (auto& event : events)
-				{
-					std::cout << event << " would have been deleted without dry run" << endl;
-					count++;
-				}
-			} 
-
-			// If --dry-run is not given, delete all events
-			if (argc == 3)
-			{
-				// Empty events.csv
-				try
-				{
-					for (auto& event : events)
-					{
-						update_csv_file(eventsPath, tempPath, argv, event);
-						count++;
-					}
-					std::cout << "Deleted all events" << endl;
-				}
-				catch (const std::exception&)
-				{
-					std::cout << "Error opening file" << std::endl;
-				}
+				std::cout << "Deleted event " << table.event(row) << endl;
+				table.erase(row);
 			}
+			count++;
 		}
-		string arg_between = "--between";
 
-		// --between command
-		if (argv[2] == arg_between)
+		if (!dry_run && count > 0)
 		{
-			if (argc != 5 && argc != 6)
-			{
-				std::cerr << "No dates given or wrong formatting" << endl;
-				return 0;
-			}
-
-			auto date1 = tools.getDateFromString(argv[3]);
-			auto date2 = tools.getDateFromString(argv[4]);
-			if (!date1.has_value() || !date2.has_value())
-			{
-				std::cerr << "bad date: " << argv[3] << " or " << argv[4] << '\n';
-				return 0;
-			}
-
-			// If --dry-run is given, just print what would have been deleted
-			for (auto& event : events)
+			if (!table.save(eventsPath))
 			{
-				if (event.getTimestamp() >= date1.value() && event.getTimestamp() <= date2.value() && argv[length] == arg_dry_run)
-				{
-					std::cout << event << " would have been deleted without dry run" << endl;
-					count++;
-				}
-
-				if (event.getTimestamp() >= date1.value() && event.getTimestamp() <= date2.value() && argv[length] != arg_dry_run)
-				{
-					update_csv_file(eventsPath, tempPath, argv, event);
-					count++;
-				}
+				std::cout << "An error occured while writing to file." << endl;
 			}
-		
+			TrigramIndex::invalidate(eventsPath);
+			DescriptionIndex::invalidate(eventsPath);
 		}
 	}
 
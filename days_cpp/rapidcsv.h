@@ -15,21 +15,55 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <cmath>
-#ifdef HAS_CODECVT
-#include <codecvt>
-#include <locale>
-#endif
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
+#if defined(__has_include)
+#if __has_include(<charconv>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <charconv>
+#include <system_error>
+#define RAPIDCSV_HAS_FROM_CHARS
+#endif
+#if __has_include(<string_view>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <iterator>
+#include <string_view>
+#define RAPIDCSV_HAS_STRING_VIEW
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAPIDCSV_HAS_SSE2
+#endif
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#if defined(__has_include)
+#if __has_include(<filesystem>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <filesystem>
+#define RAPIDCSV_HAS_FILESYSTEM
+#endif
+#endif
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #if defined(_MSC_VER)
 #include <BaseTsd.h>
 typedef SSIZE_T ssize_t;
@@ -162,6 +196,13 @@ namespace rapidcsv
          */
         void ToVal(const std::string& pStr, T& pVal) const
         {
+#ifdef RAPIDCSV_HAS_FROM_CHARS
+            if (!mConverterParams.mNumericLocale && ToValFromChars(pStr, pVal))
+            {
+                return;
+            }
+#endif
+
             try
             {
                 if (typeid(T) == typeid(int))
@@ -269,6 +310,159 @@ namespace rapidcsv
         }
 
     private:
+#ifdef RAPIDCSV_HAS_FROM_CHARS
+        /**
+         * @brief   Converts string holding a numerical value with std::from_chars, which
+         *          neither allocates nor consults the locale. Accepts the same input as the
+         *          stream-based path: leading whitespace and a sign, and for integers any
+         *          trailing characters, like std::stoi and friends, which also set the type
+         *          parsed into. Failures throw, or yield the default value, the same way.
+         * @param   pStr                  string
+         * @param   pVal                  numerical value
+         * @returns false if T has no from_chars conversion.
+         */
+        bool ToValFromChars(const std::string& pStr, T& pVal) const
+        {
+            try
+            {
+                if constexpr (std::is_same<T, int>::value)
+                {
+                    pVal = static_cast<T>(FromCharsInteger<int>(pStr));
+                }
+                else if constexpr (std::is_same<T, long>::value)
+                {
+                    pVal = static_cast<T>(FromCharsInteger<long>(pStr));
+                }
+                else if constexpr (std::is_same<T, long long>::value)
+                {
+                    pVal = static_cast<T>(FromCharsInteger<long long>(pStr));
+                }
+                else if constexpr (std::is_same<T, unsigned>::value ||
+                                   std::is_same<T, unsigned long>::value)
+                {
+                    pVal = static_cast<T>(FromCharsInteger<unsigned long>(pStr));
+                }
+                else if constexpr (std::is_same<T, unsigned long long>::value)
+                {
+                    pVal = static_cast<T>(FromCharsInteger<unsigned long long>(pStr));
+                }
+#if defined(__cpp_lib_to_chars)
+                else if constexpr (std::is_same<T, float>::value ||
+                                   std::is_same<T, double>::value ||
+                                   std::is_same<T, long double>::value)
+                {
+                    pVal = FromCharsFloat(pStr);
+                }
+#endif
+                else
+                {
+                    return false;
+                }
+                return true;
+            }
+            catch (...)
+            {
+                if (!mConverterParams.mHasDefaultConverter)
+                {
+                    throw;
+                }
+                pVal = std::is_floating_point<T>::value ?
+                    static_cast<T>(mConverterParams.mDefaultFloat) :
+                    static_cast<T>(mConverterParams.mDefaultInteger);
+                return true;
+            }
+        }
+
+        /**
+         * @brief   Skips leading whitespace and a plus sign, as strtol and operator>> do.
+         * @param   pFirst                start of the text, advanced past what was skipped
+         * @param   pLast                 end of the text
+         */
+        static void SkipSpaceAndPlus(const char*& pFirst, const char* pLast)
+        {
+            while ((pFirst != pLast) && std::isspace(static_cast<unsigned char>(*pFirst)))
+            {
+                ++pFirst;
+            }
+            if ((pLast - pFirst > 1) && (pFirst[0] == '+') && (pFirst[1] != '-') && (pFirst[1] != '+'))
+            {
+                ++pFirst;
+            }
+        }
+
+        /**
+         * @brief   Integer conversion with the semantics of std::stoi and friends: parses the
+         *          longest valid prefix, and a minus sign on an unsigned type negates modulo
+         *          2^N like strtoul.
+         * @param   pStr                  string
+         * @returns the value
+         */
+        template<typename U>
+        static U FromCharsInteger(const std::string& pStr)
+        {
+            const char* first = pStr.data();
+            const char* last = first + pStr.size();
+            SkipSpaceAndPlus(first, last);
+            bool negate = false;
+            if (std::is_unsigned<U>::value && (first != last) && (*first == '-'))
+            {
+                negate = true;
+                ++first;
+            }
+
+            U value = 0;
+            const std::from_chars_result result = std::from_chars(first, last, value);
+            if (result.ec == std::errc::invalid_argument)
+            {
+                throw std::invalid_argument("from_chars: no conversion");
+            }
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                throw std::out_of_range("from_chars: out of range");
+            }
+            return negate ? static_cast<U>(U(0) - value) : value;
+        }
+
+#if defined(__cpp_lib_to_chars)
+        /**
+         * @brief   Floating-point conversion with the semantics of the istringstream path:
+         *          the whole string has to be a number.
+         * @param   pStr                  string
+         * @returns the value
+         */
+        static T FromCharsFloat(const std::string& pStr)
+        {
+            const char* first = pStr.data();
+            const char* last = first + pStr.size();
+            SkipSpaceAndPlus(first, last);
+            const char* digits = ((first != last) && (*first == '-')) ? first + 1 : first;
+            if ((digits == last) || (!std::isdigit(static_cast<unsigned char>(*digits)) && (*digits != '.')))
+            {
+                throw std::invalid_argument("from_chars: no conversion"); // no inf or nan, like operator>>
+            }
+
+            T value = 0;
+            const std::from_chars_result result = std::from_chars(first, last, value);
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                // Rare; the stream tells overflow from underflow, which it rounds to zero.
+                std::istringstream iss(pStr);
+                iss >> value;
+                if (iss.fail() || iss.bad() || !iss.eof())
+                {
+                    throw std::invalid_argument("istringstream: no conversion");
+                }
+                return value;
+            }
+            if ((result.ec != std::errc()) || (result.ptr != last))
+            {
+                throw std::invalid_argument("from_chars: no conversion");
+            }
+            return value;
+        }
+#endif
+#endif
+
         const ConverterParams& mConverterParams;
     };
 
@@ -442,6 +636,423 @@ namespace rapidcsv
         bool mSkipEmptyLines;
     };
 
+#ifdef RAPIDCSV_HAS_STRING_VIEW
+    /**
+     * @brief     Read-only view of one column of a Document, as returned by
+     *            Document::GetColumnView. Nothing is copied when the view is created: cells are
+     *            read from the document as they are accessed, either as std::string_view into
+     *            the document's storage or converted to T on each access. The view and its
+     *            elements are invalidated by any change to the document.
+     */
+    template<typename T>
+    class ColumnView
+    {
+    public:
+        /**
+         * @brief   Iterator over the cells of a ColumnView.
+         */
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = T;
+
+            Iterator(const ColumnView* pView, const size_t pRowIdx)
+                : mView(pView)
+                , mRowIdx(pRowIdx)
+            {
+            }
+
+            T operator*() const
+            {
+                return (*mView)[mRowIdx];
+            }
+
+            Iterator& operator++()
+            {
+                ++mRowIdx;
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator previous = *this;
+                ++mRowIdx;
+                return previous;
+            }
+
+            bool operator==(const Iterator& pOther) const
+            {
+                return mRowIdx == pOther.mRowIdx;
+            }
+
+            bool operator!=(const Iterator& pOther) const
+            {
+                return mRowIdx != pOther.mRowIdx;
+            }
+
+        private:
+            const ColumnView* mView;
+            size_t mRowIdx;
+        };
+
+        /**
+         * @brief   Constructor, only intended for Document::GetColumnView.
+         * @param   pData                 rows of the document, including label rows and columns.
+         * @param   pFirstRowIdx          index in pData of the first data row.
+         * @param   pFirstColumnIdx       index in a row of pData of the first data column.
+         * @param   pColumnIdx            zero-based data column index.
+         * @param   pConverterParams      conversion parameters of the document.
+         */
+        ColumnView(const std::vector<std::vector<std::string>>& pData, const size_t pFirstRowIdx,
+                   const size_t pFirstColumnIdx, const size_t pColumnIdx,
+                   const ConverterParams& pConverterParams)
+            : mData(&pData)
+            , mFirstRowIdx(pFirstRowIdx)
+            , mFirstColumnIdx(pFirstColumnIdx)
+            , mColumnIdx(pColumnIdx)
+            , mConverterParams(&pConverterParams)
+        {
+        }
+
+        /**
+         * @brief   Get number of data rows in the column.
+         * @returns row count.
+         */
+        size_t size() const
+        {
+            return mData->size() > mFirstRowIdx ? mData->size() - mFirstRowIdx : 0;
+        }
+
+        /**
+         * @brief   Check whether the column has no data rows.
+         * @returns true if size() is zero.
+         */
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief   Get cell of the column, which must be less than size(). Throws
+         *          std::out_of_range if the row is too short to have the column.
+         * @param   pRowIdx               zero-based row index.
+         * @returns cell data.
+         */
+        T operator[](const size_t pRowIdx) const
+        {
+            const std::vector<std::string>& row = (*mData)[mFirstRowIdx + pRowIdx];
+            const size_t dataColumnIdx = mFirstColumnIdx + mColumnIdx;
+            if (dataColumnIdx >= row.size())
+            {
+                const std::string errStr = "requested column index " +
+                    std::to_string(mColumnIdx) + " >= " +
+                    std::to_string(row.size() - mFirstColumnIdx) +
+                    " (number of columns on row index " + std::to_string(pRowIdx) + ")";
+                throw std::out_of_range(errStr);
+            }
+
+            const std::string& cell = row[dataColumnIdx];
+            if constexpr (std::is_same<T, std::string_view>::value)
+            {
+                return std::string_view(cell);
+            }
+            else
+            {
+                T val;
+                Converter<T> converter(*mConverterParams);
+                converter.ToVal(cell, val);
+                return val;
+            }
+        }
+
+        /**
+         * @brief   Get cell of the column, checking the row index.
+         * @param   pRowIdx               zero-based row index.
+         * @returns cell data.
+         */
+        T at(const size_t pRowIdx) const
+        {
+            if (pRowIdx >= size())
+            {
+                throw std::out_of_range("requested row index " + std::to_string(pRowIdx) + " >= " +
+                                        std::to_string(size()) + " (number of rows)");
+            }
+            return (*this)[pRowIdx];
+        }
+
+        /**
+         * @brief   Get iterator to the first cell.
+         * @returns iterator.
+         */
+        Iterator begin() const
+        {
+            return Iterator(this, 0);
+        }
+
+        /**
+         * @brief   Get iterator past the last cell.
+         * @returns iterator.
+         */
+        Iterator end() const
+        {
+            return Iterator(this, size());
+        }
+
+    private:
+        const std::vector<std::vector<std::string>>* mData;
+        size_t mFirstRowIdx;
+        size_t mFirstColumnIdx;
+        size_t mColumnIdx;
+        const ConverterParams* mConverterParams;
+    };
+#endif
+
+    /**
+     * @brief     Incremental UTF-16 to UTF-8 transcoder, used by Document to read UTF-16 files
+     *            block by block. Only intended for rapidcsv internal usage. Runs of ASCII are
+     *            narrowed 16 code units at a time; unpaired surrogates become U+FFFD.
+     */
+    class Utf16Decoder
+    {
+    public:
+        /**
+         * @brief   Constructor
+         * @param   pIsLE                 specifies whether the input is little endian.
+         */
+        explicit Utf16Decoder(const bool pIsLE)
+            : mIsLE(pIsLE)
+        {
+        }
+
+        /**
+         * @brief   Get upper bound of the number of bytes one Decode call writes.
+         * @param   pLength               number of input bytes.
+         * @returns output buffer size needed.
+         */
+        static size_t MaxDecodedLength(const size_t pLength)
+        {
+            return pLength / 2 * 3 + 16;
+        }
+
+        /**
+         * @brief   Transcodes the next block of input. A code unit or surrogate pair split
+         *          between blocks is completed by the next call.
+         * @param   pIn                   input bytes.
+         * @param   pLength               number of input bytes.
+         * @param   pIsLast               specifies whether this is the last block.
+         * @param   pOut                  output buffer of at least MaxDecodedLength(pLength) bytes.
+         * @returns number of bytes written.
+         */
+        size_t Decode(const char* pIn, const size_t pLength, const bool pIsLast, char* pOut)
+        {
+            char* out = pOut;
+            size_t i = 0;
+            if (mHasPendingByte && (pLength > 0))
+            {
+                out = Put(Unit(mPendingByte, pIn[0]), out);
+                mHasPendingByte = false;
+                i = 1;
+            }
+
+            while (i + 2 <= pLength)
+            {
+                if ((mPendingSurrogate == 0) && (i + 32 <= pLength) && NarrowAscii(pIn + i, out))
+                {
+                    i += 32;
+                    out += 16;
+                    continue;
+                }
+
+                // at least one non-ASCII unit in the next 16, convert them one by one
+                const size_t end = std::min(i + 32, i + (pLength - i) / 2 * 2);
+                for (; i < end; i += 2)
+                {
+                    out = Put(Unit(pIn[i], pIn[i + 1]), out);
+                }
+            }
+
+            if (i < pLength)
+            {
+                mPendingByte = pIn[i];
+                mHasPendingByte = true;
+            }
+
+            if (pIsLast && (mHasPendingByte || (mPendingSurrogate != 0)))
+            {
+                out = PutCodePoint(0xfffd, out);
+                mHasPendingByte = false;
+                mPendingSurrogate = 0;
+            }
+            return static_cast<size_t>(out - pOut);
+        }
+
+    private:
+        uint16_t Unit(const char pFirst, const char pSecond) const
+        {
+            const uint16_t first = static_cast<unsigned char>(pFirst);
+            const uint16_t second = static_cast<unsigned char>(pSecond);
+            return mIsLE ? static_cast<uint16_t>(first | (second << 8)) : static_cast<uint16_t>((first << 8) | second);
+        }
+
+        // Writes 16 ASCII bytes for the 16 units at pIn, if they all are ASCII.
+        bool NarrowAscii(const char* pIn, char* pOut) const
+        {
+#ifdef RAPIDCSV_HAS_SSE2
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + 16));
+            if (!mIsLE)
+            {
+                low = _mm_or_si128(_mm_slli_epi16(low, 8), _mm_srli_epi16(low, 8));
+                high = _mm_or_si128(_mm_slli_epi16(high, 8), _mm_srli_epi16(high, 8));
+            }
+            const __m128i nonAscii = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(static_cast<short>(0xff80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) != 0xffff)
+            {
+                return false;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), _mm_packus_epi16(low, high));
+            return true;
+#else
+            uint64_t words[4];
+            std::memcpy(words, pIn, sizeof(words));
+            const uint64_t asciiMask = mIsLE ? 0xff80ff80ff80ff80ull : 0x80ff80ff80ff80ffull;
+            if (((words[0] | words[1] | words[2] | words[3]) & asciiMask) != 0)
+            {
+                return false;
+            }
+            const size_t ascii = mIsLE ? 0 : 1;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                pOut[i] = pIn[2 * i + ascii];
+            }
+            return true;
+#endif
+        }
+
+        char* Put(const uint16_t pUnit, char* pOut)
+        {
+            if (mPendingSurrogate != 0)
+            {
+                const uint32_t high = mPendingSurrogate;
+                mPendingSurrogate = 0;
+                if ((pUnit >= 0xdc00) && (pUnit <= 0xdfff))
+                {
+                    return PutCodePoint(0x10000 + ((high - 0xd800) << 10) + (pUnit - 0xdc00u), pOut);
+                }
+                pOut = PutCodePoint(0xfffd, pOut);
+            }
+
+            if ((pUnit >= 0xd800) && (pUnit <= 0xdbff))
+            {
+                mPendingSurrogate = pUnit;
+                return pOut;
+            }
+            if ((pUnit >= 0xdc00) && (pUnit <= 0xdfff))
+            {
+                return PutCodePoint(0xfffd, pOut);
+            }
+            return PutCodePoint(pUnit, pOut);
+        }
+
+        static char* PutCodePoint(const uint32_t pCodePoint, char* pOut)
+        {
+            if (pCodePoint < 0x80)
+            {
+                *pOut++ = static_cast<char>(pCodePoint);
+            }
+            else if (pCodePoint < 0x800)
+            {
+                *pOut++ = static_cast<char>(0xc0 | (pCodePoint >> 6));
+                *pOut++ = static_cast<char>(0x80 | (pCodePoint & 0x3f));
+            }
+            else if (pCodePoint < 0x10000)
+            {
+                *pOut++ = static_cast<char>(0xe0 | (pCodePoint >> 12));
+                *pOut++ = static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3f));
+                *pOut++ = static_cast<char>(0x80 | (pCodePoint & 0x3f));
+            }
+            else
+            {
+                *pOut++ = static_cast<char>(0xf0 | (pCodePoint >> 18));
+                *pOut++ = static_cast<char>(0x80 | ((pCodePoint >> 12) & 0x3f));
+                *pOut++ = static_cast<char>(0x80 | ((pCodePoint >> 6) & 0x3f));
+                *pOut++ = static_cast<char>(0x80 | (pCodePoint & 0x3f));
+            }
+            return pOut;
+        }
+
+    private:
+        bool mIsLE;
+        bool mHasPendingByte = false;
+        char mPendingByte = 0;
+        uint16_t mPendingSurrogate = 0;
+    };
+
+    /**
+     * @brief     Transcodes UTF-8 to UTF-16, used by Document to write back UTF-16 files. Only
+     *            intended for rapidcsv internal usage. Invalid UTF-8 becomes U+FFFD.
+     * @param     pStr                  UTF-8 input.
+     * @param     pIsLE                 specifies whether to write little endian.
+     * @param     pOut                  UTF-16 output bytes, appended to.
+     */
+    inline void EncodeUtf16(const std::string& pStr, const bool pIsLE, std::string& pOut)
+    {
+        const auto putUnit = [&](const uint32_t pUnit)
+        {
+            const char low = static_cast<char>(pUnit & 0xff);
+            const char high = static_cast<char>(pUnit >> 8);
+            pOut.push_back(pIsLE ? low : high);
+            pOut.push_back(pIsLE ? high : low);
+        };
+
+        pOut.reserve(pOut.size() + 2 * pStr.size());
+        const size_t length = pStr.size();
+        size_t i = 0;
+        while (i < length)
+        {
+            const unsigned char lead = static_cast<unsigned char>(pStr[i]);
+            if (lead < 0x80)
+            {
+                putUnit(lead);
+                ++i;
+                continue;
+            }
+
+            const size_t extra = (lead >= 0xf0) ? 3 : (lead >= 0xe0) ? 2 : (lead >= 0xc0) ? 1 : 0;
+            uint32_t codePoint = lead & (0x3f >> extra);
+            bool valid = (extra > 0) && (lead < 0xf5) && (i + extra < length);
+            for (size_t k = 1; valid && (k <= extra); ++k)
+            {
+                const unsigned char next = static_cast<unsigned char>(pStr[i + k]);
+                valid = ((next & 0xc0) == 0x80);
+                codePoint = (codePoint << 6) | (next & 0x3f);
+            }
+            static const uint32_t minimum[4] = { 0, 0x80, 0x800, 0x10000 };
+            if (!valid || (codePoint < minimum[extra]) || (codePoint > 0x10ffff) ||
+                ((codePoint >= 0xd800) && (codePoint <= 0xdfff)))
+            {
+                putUnit(0xfffd);
+                ++i;
+                continue;
+            }
+
+            if (codePoint >= 0x10000)
+            {
+                putUnit(0xd800 + ((codePoint - 0x10000) >> 10));
+                putUnit(0xdc00 + ((codePoint - 0x10000) & 0x3ff));
+            }
+            else
+            {
+                putUnit(codePoint);
+            }
+            i += extra + 1;
+        }
+    }
+
     /**
      * @brief     Class representing a CSV document.
      */
@@ -575,6 +1186,91 @@ namespace rapidcsv
             WriteCsv(pStream);
         }
 
+        /**
+         * @brief   Write Document data to file so that the file is never seen half written. The
+         *          data is written to a temporary file next to the target (its path with ".tmp"
+         *          appended), which is flushed to disk and then renamed over the target, so after
+         *          a crash the file holds either the old or the new data.
+         * @param   pPath                 optionally specifies the path where the CSV-file will be created
+         *                                (if not specified, the original path provided when creating or
+         *                                loading the Document data will be used).
+         */
+        void SaveAtomic(const std::string& pPath = std::string())
+        {
+            if (!pPath.empty())
+            {
+                mPath = pPath;
+            }
+
+            const std::string tempPath = mPath + ".tmp";
+            try
+            {
+                WriteCsv(tempPath);
+                SyncFile(tempPath);
+                ReplaceFile(tempPath, mPath);
+            }
+            catch (...)
+            {
+                std::remove(tempPath.c_str());
+                // the row offsets describe the temporary file, which did not replace mPath, so
+                // the next SaveIncremental rewrites it in full
+                mRowOffsets.clear();
+                mCleanRows = 0;
+                throw;
+            }
+        }
+
+        /**
+         * @brief   Write changes to the file the Document was loaded from or last saved to,
+         *          rewriting it only from the first row that was changed, inserted or removed
+         *          since. When rows were only appended, they are appended to the file. The file
+         *          must not have been modified by others in the meantime, and unlike SaveAtomic
+         *          an interrupted update leaves a partly written file. Documents read from a
+         *          stream or from a UTF-16 file are saved in full.
+         */
+        void SaveIncremental()
+        {
+            if (mRowOffsets.empty())
+            {
+                WriteCsv();
+                return;
+            }
+
+            const uint64_t start = mRowOffsets[mCleanRows];
+            const uint64_t oldLength = mRowOffsets.back();
+            if ((mCleanRows == mData.size()) && (start == oldLength))
+            {
+                return;
+            }
+
+            try
+            {
+                mRowOffsets.resize(mCleanRows);
+                std::fstream stream;
+                stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+                stream.open(mPath, std::ios::in | std::ios::out | std::ios::binary);
+                stream.seekp(static_cast<std::streamoff>(start));
+                FormatRows(mCleanRows, mData.size(), [&](const std::string& pBlock)
+                {
+                    stream.write(pBlock.data(), static_cast<std::streamsize>(pBlock.size()));
+                }, &mRowOffsets, start);
+                stream.close();
+
+                if (mRowOffsets.back() < oldLength)
+                {
+                    TruncateFile(mPath, mRowOffsets.back());
+                }
+                mCleanRows = mData.size();
+            }
+            catch (...)
+            {
+                // the file layout is unknown now, the next save rewrites it in full
+                mRowOffsets.clear();
+                mCleanRows = 0;
+                throw;
+            }
+        }
+
         /**
          * @brief   Clears loaded Document data.
          *
@@ -584,10 +1280,10 @@ namespace rapidcsv
             mData.clear();
             mColumnNames.clear();
             mRowNames.clear();
-#ifdef HAS_CODECVT
             mIsUtf16 = false;
             mIsLE = false;
-#endif
+            mRowOffsets.clear();
+            mCleanRows = 0;
         }
 
         /**
@@ -599,9 +1295,10 @@ namespace rapidcsv
         {
             if (mLabelParams.mColumnNameIdx >= 0)
             {
-                if (mColumnNames.find(pColumnName) != mColumnNames.end())
+                const auto it = mColumnNames.find(pColumnName);
+                if (it != mColumnNames.end())
                 {
-                    return static_cast<ssize_t>(mColumnNames.at(pColumnName)) - (mLabelParams.mRowNameIdx + 1);
+                    return static_cast<ssize_t>(it->second) - (mLabelParams.mRowNameIdx + 1);
                 }
             }
             return -1;
@@ -699,6 +1396,39 @@ namespace rapidcsv
             return GetColumn<T>(static_cast<size_t>(columnIdx), pToVal);
         }
 
+#ifdef RAPIDCSV_HAS_STRING_VIEW
+        /**
+         * @brief   Get view of column by index, without copying its data. With T
+         *          std::string_view (default) the cells are views into the document; other
+         *          types are converted as cells are read. The view is invalidated by any change
+         *          to the document.
+         * @param   pColumnIdx            zero-based column index.
+         * @returns view of column data.
+         */
+        template<typename T = std::string_view>
+        ColumnView<T> GetColumnView(const size_t pColumnIdx) const
+        {
+            const size_t firstRowIdx = static_cast<size_t>(mLabelParams.mColumnNameIdx + 1);
+            return ColumnView<T>(mData, firstRowIdx, GetDataColumnIndex(0), pColumnIdx, mConverterParams);
+        }
+
+        /**
+         * @brief   Get view of column by name, without copying its data.
+         * @param   pColumnName           column label name.
+         * @returns view of column data.
+         */
+        template<typename T = std::string_view>
+        ColumnView<T> GetColumnView(const std::string& pColumnName) const
+        {
+            const ssize_t columnIdx = GetColumnIdx(pColumnName);
+            if (columnIdx < 0)
+            {
+                throw std::out_of_range("column not found: " + pColumnName);
+            }
+            return GetColumnView<T>(static_cast<size_t>(columnIdx));
+        }
+#endif
+
         /**
          * @brief   Set column by index.
          * @param   pColumnIdx            zero-based column index.
@@ -724,6 +1454,7 @@ namespace rapidcsv
                 }
             }
 
+            MarkRowsChanged(0);
             Converter<T> converter(mConverterParams);
             for (auto itRow = pColumn.begin(); itRow != pColumn.end(); ++itRow)
             {
@@ -762,6 +1493,7 @@ namespace rapidcsv
                 itRow->erase(itRow->begin() + static_cast<ssize_t>(dataColumnIdx));
             }
 
+            MarkRowsChanged(0);
             UpdateColumnNames();
         }
 
@@ -825,6 +1557,7 @@ namespace rapidcsv
                 const size_t rowIdx = static_cast<size_t>(std::distance(mData.begin(), itRow));
                 itRow->insert(itRow->begin() + static_cast<ssize_t>(dataColumnIdx), column.at(rowIdx));
             }
+            MarkRowsChanged(0);
 
             if (!pColumnName.empty())
             {
@@ -846,7 +1579,10 @@ namespace rapidcsv
         }
 
         /**
-         * @brief   Get row index by name.
+         * @brief   Get row index by name. The map from row names to indices is only kept
+         *          when LabelParams has a row label column, so documents without row labels
+         *          don't pay for it. It is rebuilt when rows are read, inserted or removed,
+         *          never by a lookup, so const accessors can be called from several threads.
          * @param   pRowName              row label name.
          * @returns zero-based row index.
          */
@@ -854,9 +1590,10 @@ namespace rapidcsv
         {
             if (mLabelParams.mRowNameIdx >= 0)
             {
-                if (mRowNames.find(pRowName) != mRowNames.end())
+                const auto it = mRowNames.find(pRowName);
+                if (it != mRowNames.end())
                 {
-                    return static_cast<ssize_t>(mRowNames.at(pRowName)) - (mLabelParams.mColumnNameIdx + 1);
+                    return static_cast<ssize_t>(it->second) - (mLabelParams.mColumnNameIdx + 1);
                 }
             }
             return -1;
@@ -965,8 +1702,10 @@ namespace rapidcsv
                 {
                     itRow->resize(GetDataColumnIndex(pRow.size()));
                 }
+                MarkRowsChanged(0);
             }
 
+            MarkRowsChanged(dataRowIdx);
             Converter<T> converter(mConverterParams);
             for (auto itCol = pRow.begin(); itCol != pRow.end(); ++itCol)
             {
@@ -1001,6 +1740,7 @@ namespace rapidcsv
         {
             const size_t dataRowIdx = GetDataRowIndex(pRowIdx);
             mData.erase(mData.begin() + static_cast<ssize_t>(dataRowIdx));
+            MarkRowsChanged(dataRowIdx);
             UpdateRowNames();
         }
 
@@ -1056,6 +1796,7 @@ namespace rapidcsv
             }
 
             mData.insert(mData.begin() + static_cast<ssize_t>(rowIdx), row);
+            MarkRowsChanged(rowIdx);
 
             if (!pRowName.empty())
             {
@@ -1259,8 +2000,10 @@ namespace rapidcsv
                 {
                     itRow->resize(dataColumnIdx + 1);
                 }
+                MarkRowsChanged(0);
             }
 
+            MarkRowsChanged(dataRowIdx);
             std::string str;
             Converter<T> converter(mConverterParams);
             converter.ToStr(pCell, str);
@@ -1333,6 +2076,7 @@ namespace rapidcsv
             {
                 row.resize(dataColumnIdx + 1);
             }
+            MarkRowsChanged(rowIdx);
 
             mData.at(static_cast<size_t>(mLabelParams.mColumnNameIdx)).at(dataColumnIdx) = pColumnName;
         }
@@ -1393,6 +2137,7 @@ namespace rapidcsv
             {
                 row.resize(static_cast<size_t>(mLabelParams.mRowNameIdx) + 1);
             }
+            MarkRowsChanged(dataRowIdx);
 
             mData.at(dataRowIdx).at(static_cast<size_t>(mLabelParams.mRowNameIdx)) = pRowName;
         }
@@ -1423,17 +2168,16 @@ namespace rapidcsv
             std::ifstream stream;
             stream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
             stream.open(mPath, std::ios::binary);
-            ReadCsv(stream);
+            ReadCsv(stream, true);
         }
 
-        void ReadCsv(std::istream& pStream)
+        void ReadCsv(std::istream& pStream, const bool pIsFile = false)
         {
             Clear();
             pStream.seekg(0, std::ios::end);
             std::streamsize length = pStream.tellg();
             pStream.seekg(0, std::ios::beg);
 
-#ifdef HAS_CODECVT
             std::vector<char> bom2b(2, '\0');
             if (length >= 2)
             {
@@ -1445,33 +2189,14 @@ namespace rapidcsv
             static const std::vector<char> bomU16be = { '\xfe', '\xff' };
             if ((bom2b == bomU16le) || (bom2b == bomU16be))
             {
+                // transcoded to UTF-8 block by block while parsing
                 mIsUtf16 = true;
                 mIsLE = (bom2b == bomU16le);
-
-                std::wifstream wstream;
-                wstream.exceptions(std::wifstream::failbit | std::wifstream::badbit);
-                wstream.open(mPath, std::ios::binary);
-                if (mIsLE)
-                {
-                    wstream.imbue(std::locale(wstream.getloc(),
-                        new std::codecvt_utf16<wchar_t, 0x10ffff,
-                        static_cast<std::codecvt_mode>(std::consume_header |
-                            std::little_endian)>));
-                }
-                else
-                {
-                    wstream.imbue(std::locale(wstream.getloc(),
-                        new std::codecvt_utf16<wchar_t, 0x10ffff,
-                        std::consume_header>));
-                }
-                std::wstringstream wss;
-                wss << wstream.rdbuf();
-                std::string utf8 = ToString(wss.str());
-                std::stringstream ss(utf8);
-                ParseCsv(ss, static_cast<std::streamsize>(utf8.size()));
+                pStream.seekg(2, std::ios::beg);
+                Utf16Decoder decoder(mIsLE);
+                ParseCsv(pStream, length - 2, &decoder);
             }
             else
-#endif
             {
                 // check for UTF-8 Byte order mark and skip it when found
                 if (length >= 3)
@@ -1493,12 +2218,23 @@ namespace rapidcsv
 
                 ParseCsv(pStream, length);
             }
+
+            // row offsets are only kept for UTF-8 files at mPath, see SaveIncremental
+            if (!pIsFile || mIsUtf16)
+            {
+                mRowOffsets.clear();
+                mCleanRows = 0;
+            }
         }
 
-        void ParseCsv(std::istream& pStream, std::streamsize p_FileLength)
+        void ParseCsv(std::istream& pStream, std::streamsize p_FileLength, Utf16Decoder* pDecoder = nullptr)
         {
             const std::streamsize bufLength = 64 * 1024;
-            std::vector<char> buffer(bufLength);
+            std::vector<char> buffer(pDecoder ? Utf16Decoder::MaxDecodedLength(bufLength) : bufLength);
+            std::vector<char> utf16Buffer(pDecoder ? bufLength : 0);
+            const std::streamoff start = pStream.tellg();
+            uint64_t blockOffset = (start > 0) ? static_cast<uint64_t>(start) : 0;
+            uint64_t rowOffset = blockOffset;
             std::vector<std::string> row;
             std::string cell;
             bool quoted = false;
@@ -1508,7 +2244,7 @@ namespace rapidcsv
             while (p_FileLength > 0)
             {
                 const std::streamsize toReadLength = std::min<std::streamsize>(p_FileLength, bufLength);
-                pStream.read(buffer.data(), toReadLength);
+                pStream.read(pDecoder ? utf16Buffer.data() : buffer.data(), toReadLength);
 
                 // With user-specified istream opened in non-binary mode on windows, we may have a
                 // data length mismatch, so ensure we don't parse outside actual data length read.
@@ -1518,7 +2254,14 @@ namespace rapidcsv
                     break;
                 }
 
-                for (size_t i = 0; i < static_cast<size_t>(readLength); ++i)
+                size_t dataLength = static_cast<size_t>(readLength);
+                if (pDecoder)
+                {
+                    const bool isLast = (readLength < toReadLength) || (readLength == p_FileLength);
+                    dataLength = pDecoder->Decode(utf16Buffer.data(), dataLength, isLast, buffer.data());
+                }
+
+                for (size_t i = 0; i < dataLength; ++i)
                 {
                     if (buffer[i] == mSeparatorParams.mQuoteChar)
                     {
@@ -1576,12 +2319,14 @@ namespace rapidcsv
                                 else
                                 {
                                     mData.push_back(row);
+                                    mRowOffsets.push_back(rowOffset);
                                 }
 
                                 cell.clear();
                                 row.clear();
                                 quoted = false;
                             }
+                            rowOffset = blockOffset + i + 1;
                         }
                     }
                     else
@@ -1590,16 +2335,20 @@ namespace rapidcsv
                     }
                 }
                 p_FileLength -= readLength;
+                blockOffset += static_cast<uint64_t>(readLength);
             }
 
             // Handle last line without linebreak
+            mCleanRows = mData.size();
             if (!cell.empty() || !row.empty())
             {
                 row.push_back(Unquote(Trim(cell)));
                 cell.clear();
                 mData.push_back(row);
+                mRowOffsets.push_back(rowOffset);
                 row.clear();
             }
+            mRowOffsets.push_back(blockOffset);
 
             // Assume CR/LF if at least half the linebreaks have CR
             mSeparatorParams.mHasCR = (cr > (lf / 2));
@@ -1611,76 +2360,230 @@ namespace rapidcsv
             UpdateRowNames();
         }
 
-        void WriteCsv() const
+        void WriteCsv()
         {
-#ifdef HAS_CODECVT
-            if (mIsUtf16)
-            {
-                std::stringstream ss;
-                WriteCsv(ss);
-                std::string utf8 = ss.str();
-                std::wstring wstr = ToWString(utf8);
+            WriteCsv(mPath);
+        }
 
-                std::wofstream wstream;
-                wstream.exceptions(std::wofstream::failbit | std::wofstream::badbit);
-                wstream.open(mPath, std::ios::binary | std::ios::trunc);
+        void WriteCsv(const std::string& pPath)
+        {
+            mRowOffsets.clear();
+            mCleanRows = 0;
 
-                if (mIsLE)
-                {
-                    wstream.imbue(std::locale(wstream.getloc(),
-                        new std::codecvt_utf16<wchar_t, 0x10ffff,
-                        static_cast<std::codecvt_mode>(std::little_endian)>));
-                }
-                else
+            std::ofstream stream;
+            stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+            stream.open(pPath, std::ios::binary | std::ios::trunc);
+            if (mIsUtf16)
+            {
+                std::string utf16 = mIsLE ? "\xff\xfe" : "\xfe\xff";
+                FormatRows(0, mData.size(), [&](const std::string& pBlock)
                 {
-                    wstream.imbue(std::locale(wstream.getloc(),
-                        new std::codecvt_utf16<wchar_t, 0x10ffff>));
-                }
-
-                wstream << static_cast<wchar_t>(0xfeff);
-                wstream << wstr;
+                    EncodeUtf16(pBlock, mIsLE, utf16);
+                    stream.write(utf16.data(), static_cast<std::streamsize>(utf16.size()));
+                    utf16.clear();
+                });
+                stream.write(utf16.data(), static_cast<std::streamsize>(utf16.size()));
             }
             else
-#endif
             {
-                std::ofstream stream;
-                stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-                stream.open(mPath, std::ios::binary | std::ios::trunc);
-                WriteCsv(stream);
+                std::vector<uint64_t> rowOffsets;
+                FormatRows(0, mData.size(), [&](const std::string& pBlock)
+                {
+                    stream.write(pBlock.data(), static_cast<std::streamsize>(pBlock.size()));
+                }, &rowOffsets, 0);
+                stream.close();
+
+                // the file now matches the document, see SaveIncremental
+                mRowOffsets.swap(rowOffsets);
+                mCleanRows = mData.size();
             }
         }
 
         void WriteCsv(std::ostream& pStream) const
         {
-            for (auto itr = mData.begin(); itr != mData.end(); ++itr)
+            FormatRows(0, mData.size(), [&](const std::string& pBlock)
             {
-                for (auto itc = itr->begin(); itc != itr->end(); ++itc)
+                pStream.write(pBlock.data(), static_cast<std::streamsize>(pBlock.size()));
+            });
+        }
+
+        // Formats rows [pBegin, pEnd) as CSV into a reused buffer and passes it to pWrite
+        // whenever it holds sWriteBlockLength bytes or more, and once more at the end. Each
+        // block ends with a complete row. If pRowOffsets is given, the offset of each row and
+        // then of the end is appended to it, counting from pOffset for the first row.
+        void FormatRows(const size_t pBegin, const size_t pEnd,
+                        const std::function<void(const std::string&)>& pWrite,
+                        std::vector<uint64_t>* pRowOffsets = nullptr, uint64_t pOffset = 0) const
+        {
+            static const size_t sWriteBlockLength = 256 * 1024;
+            const char quoteChar = mSeparatorParams.mQuoteChar;
+            const char* lineBreak = mSeparatorParams.mHasCR ? "\r\n" : "\n";
+            std::string buffer;
+            buffer.reserve(sWriteBlockLength + 4096);
+            for (size_t rowIdx = pBegin; rowIdx < pEnd; ++rowIdx)
+            {
+                if (pRowOffsets != nullptr)
                 {
-                    if (mSeparatorParams.mAutoQuote &&
-                        ((itc->find(mSeparatorParams.mSeparator) != std::string::npos) ||
-                            (itc->find(' ') != std::string::npos)))
+                    pRowOffsets->push_back(pOffset + buffer.size());
+                }
+
+                const std::vector<std::string>& row = mData[rowIdx];
+                for (size_t columnIdx = 0; columnIdx < row.size(); ++columnIdx)
+                {
+                    const std::string& cell = row[columnIdx];
+                    if (columnIdx > 0)
                     {
-                        // escape quotes in string
-                        std::string str = *itc;
-                        const std::string quoteCharStr = std::string(1, mSeparatorParams.mQuoteChar);
-                        ReplaceString(str, quoteCharStr, quoteCharStr + quoteCharStr);
+                        buffer += mSeparatorParams.mSeparator;
+                    }
 
-                        pStream << quoteCharStr << str << quoteCharStr;
+                    if (mSeparatorParams.mAutoQuote &&
+                        ContainsEither(cell.data(), cell.size(), mSeparatorParams.mSeparator, ' '))
+                    {
+                        // quote, escaping quotes in string
+                        buffer += quoteChar;
+                        size_t pos = 0;
+                        size_t found;
+                        while ((found = cell.find(quoteChar, pos)) != std::string::npos)
+                        {
+                            buffer.append(cell, pos, found + 1 - pos);
+                            buffer += quoteChar;
+                            pos = found + 1;
+                        }
+                        buffer.append(cell, pos, std::string::npos);
+                        buffer += quoteChar;
                     }
                     else
                     {
-                        pStream << *itc;
+                        buffer += cell;
                     }
+                }
+                buffer += lineBreak;
 
-                    if (std::distance(itc, itr->end()) > 1)
-                    {
-                        pStream << mSeparatorParams.mSeparator;
-                    }
+                if (buffer.size() >= sWriteBlockLength)
+                {
+                    pWrite(buffer);
+                    pOffset += buffer.size();
+                    buffer.clear();
+                }
+            }
+            pWrite(buffer);
+            if (pRowOffsets != nullptr)
+            {
+                pRowOffsets->push_back(pOffset + buffer.size());
+            }
+        }
+
+        // Whether pStr holds pFirst or pSecond, checking 16 bytes at a time where possible.
+        static bool ContainsEither(const char* pStr, const size_t pLength, const char pFirst, const char pSecond)
+        {
+            size_t i = 0;
+#ifdef RAPIDCSV_HAS_SSE2
+            const __m128i first = _mm_set1_epi8(pFirst);
+            const __m128i second = _mm_set1_epi8(pSecond);
+            for (; i + 16 <= pLength; i += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pStr + i));
+                const __m128i found = _mm_or_si128(_mm_cmpeq_epi8(bytes, first), _mm_cmpeq_epi8(bytes, second));
+                if (_mm_movemask_epi8(found) != 0)
+                {
+                    return true;
+                }
+            }
+#endif
+            for (; i < pLength; ++i)
+            {
+                if ((pStr[i] == pFirst) || (pStr[i] == pSecond))
+                {
+                    return true;
                 }
-                pStream << (mSeparatorParams.mHasCR ? "\r\n" : "\n");
+            }
+            return false;
+        }
+
+        // Flushes the data of the file at pPath to disk.
+        static void SyncFile(const std::string& pPath)
+        {
+#if defined(_WIN32)
+            const int fd = _open(pPath.c_str(), _O_WRONLY | _O_BINARY);
+            const bool synced = (fd >= 0) && (_commit(fd) == 0);
+            if (fd >= 0)
+            {
+                _close(fd);
+            }
+#else
+            const int fd = ::open(pPath.c_str(), O_WRONLY);
+            const bool synced = (fd >= 0) && (::fsync(fd) == 0);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+#endif
+            if (!synced)
+            {
+                throw std::runtime_error("failed to flush file to disk: " + pPath);
             }
         }
 
+        // Renames pFrom over pTo, replacing it in one step, and on POSIX flushes the directory
+        // entry to disk.
+        static void ReplaceFile(const std::string& pFrom, const std::string& pTo)
+        {
+#if defined(_WIN32)
+#ifdef RAPIDCSV_HAS_FILESYSTEM
+            std::error_code error;
+            std::filesystem::rename(pFrom, pTo, error);
+            if (error)
+            {
+                throw std::runtime_error("failed to rename file: " + pFrom);
+            }
+#else
+            std::remove(pTo.c_str());
+            if (std::rename(pFrom.c_str(), pTo.c_str()) != 0)
+            {
+                throw std::runtime_error("failed to rename file: " + pFrom);
+            }
+#endif
+#else
+            if (std::rename(pFrom.c_str(), pTo.c_str()) != 0)
+            {
+                throw std::runtime_error("failed to rename file: " + pFrom);
+            }
+
+            const size_t slash = pTo.rfind('/');
+            const std::string directory = (slash == std::string::npos) ? "." : pTo.substr(0, slash + 1);
+            const int fd = ::open(directory.c_str(), O_RDONLY);
+            if (fd >= 0)
+            {
+                ::fsync(fd); // best effort, not every file system supports it
+                ::close(fd);
+            }
+#endif
+        }
+
+        static void TruncateFile(const std::string& pPath, const uint64_t pLength)
+        {
+#if defined(_WIN32)
+            const int fd = _open(pPath.c_str(), _O_WRONLY | _O_BINARY);
+            const bool truncated = (fd >= 0) && (_chsize_s(fd, static_cast<long long>(pLength)) == 0);
+            if (fd >= 0)
+            {
+                _close(fd);
+            }
+#else
+            const bool truncated = (::truncate(pPath.c_str(), static_cast<off_t>(pLength)) == 0);
+#endif
+            if (!truncated)
+            {
+                throw std::runtime_error("failed to truncate file: " + pPath);
+            }
+        }
+
+        // Marks the rows from pDataRowIdx on as changed for SaveIncremental.
+        void MarkRowsChanged(const size_t pDataRowIdx)
+        {
+            mCleanRows = std::min(mCleanRows, pDataRowIdx);
+        }
+
         size_t GetDataRowCount() const
         {
             return mData.size();
@@ -1763,6 +2666,7 @@ namespace rapidcsv
                 (static_cast<ssize_t>(mData.size()) >
                     (mLabelParams.mColumnNameIdx + 1)))
             {
+                mRowNames.reserve(mData.size());
                 size_t i = 0;
                 for (auto& dataRow : mData)
                 {
@@ -1774,25 +2678,6 @@ namespace rapidcsv
             }
         }
 
-#ifdef HAS_CODECVT
-#if defined(_MSC_VER)
-#pragma warning (push)
-#pragma warning (disable: 4996)
-#endif
-        static std::string ToString(const std::wstring& pWStr)
-        {
-            return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.to_bytes(pWStr);
-        }
-
-        static std::wstring ToWString(const std::string& pStr)
-        {
-            return std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t>{ }.from_bytes(pStr);
-        }
-#if defined(_MSC_VER)
-#pragma warning (pop)
-#endif
-#endif
-
         static void ReplaceString(std::string& pStr, const std::string& pSearch, const std::string& pReplace)
         {
             size_t pos = 0;
@@ -1811,11 +2696,14 @@ namespace rapidcsv
         ConverterParams mConverterParams;
         LineReaderParams mLineReaderParams;
         std::vector<std::vector<std::string>> mData;
-        std::map<std::string, size_t> mColumnNames;
-        std::map<std::string, size_t> mRowNames;
-#ifdef HAS_CODECVT
+        std::unordered_map<std::string, size_t> mColumnNames;
+        std::unordered_map<std::string, size_t> mRowNames;
         bool mIsUtf16 = false;
         bool mIsLE = false;
-#endif
+        // Offset in the file at mPath of each row read from or written to it, then the file
+        // length. Empty when that file's layout is unknown.
+        std::vector<uint64_t> mRowOffsets;
+        // Number of leading rows unchanged since the file was read or written.
+        size_t mCleanRows = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+// Checks rapidcsv's `Document::GetColumnView()` against `GetColumn()`:
+// string_view iteration, typed conversion of cells as they are read,
+// including cells that don't convert, and the offsets of label rows and
+// columns and of rows before the label row.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -Idays_cpp tests/rapidcsv_column_view_test.cpp -o rapidcsv_column_view_test
+// and run it; it prints every failed check and exits with 1 if there is any.
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rapidcsv.h"
+
+namespace
+{
+	bool check(bool condition, const std::string& what)
+	{
+		if (!condition)
+		{
+			std::cout << "failed: " << what << '\n';
+		}
+		return condition;
+	}
+
+	rapidcsv::Document load(const std::string& text, const rapidcsv::LabelParams& labels,
+		const rapidcsv::ConverterParams& converter = rapidcsv::ConverterParams())
+	{
+		std::istringstream input(text);
+		return rapidcsv::Document(input, labels, rapidcsv::SeparatorParams(), converter);
+	}
+
+	// Every column of `document` read through views, by iteration and by
+	// index, must equal GetColumn.
+	bool compareColumns(const rapidcsv::Document& document, const std::string& name)
+	{
+		bool passed = true;
+		for (size_t column{ 0 }; column < document.GetColumnCount(); column++)
+		{
+			const std::vector<std::string> expected = document.GetColumn<std::string>(column);
+			const auto view = document.GetColumnView(column);
+			std::vector<std::string> iterated;
+			for (std::string_view cell : view)
+			{
+				iterated.emplace_back(cell);
+			}
+			std::vector<std::string> indexed;
+			for (size_t row{ 0 }; row < view.size(); row++)
+			{
+				indexed.emplace_back(view[row]);
+			}
+			const std::string what = name + ", column " + std::to_string(column);
+			passed &= check(view.size() == expected.size(), what + ": size");
+			passed &= check(iterated == expected, what + ": iteration");
+			passed &= check(indexed == expected, what + ": indexing");
+		}
+		return passed;
+	}
+
+	template <typename Function>
+	bool throws(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+int main()
+{
+	bool passed = true;
+
+	// Label row and column offsets, and rows before the label row.
+	const std::string table = "skipped,row,here,x\nalso,skipped,too,y\nname,count,price,note\napple,3,1.5,fresh\npear,12,0.25,\nplum,-7,2e3,\"a, b\"\n";
+	passed &= compareColumns(load(table, rapidcsv::LabelParams(2, -1)), "label row 2");
+	passed &= compareColumns(load(table, rapidcsv::LabelParams(2, 0)), "label row 2 and column 0");
+	passed &= compareColumns(load(table, rapidcsv::LabelParams(0, -1)), "label row 0");
+	passed &= compareColumns(load(table, rapidcsv::LabelParams(-1, -1)), "no labels");
+	passed &= compareColumns(load(table, rapidcsv::LabelParams(-1, 1)), "label column 1");
+
+	const rapidcsv::Document document = load(table, rapidcsv::LabelParams(2, 0));
+	{
+		const auto view = document.GetColumnView("price");
+		passed &= check(view.size() == 3 && view[0] == "1.5" && view.at(2) == "2e3", "view by name");
+		passed &= check(throws([&] { return view.at(3); }), "at() checks the row index");
+		passed &= check(throws([&] { document.GetColumnView("missing"); }), "unknown column name throws");
+	}
+
+	// Typed views convert each cell when it is read.
+	{
+		const auto counts = document.GetColumnView<int>("count");
+		passed &= check(std::vector<int>(counts.begin(), counts.end()) == document.GetColumn<int>("count"), "int view");
+		const auto prices = document.GetColumnView<double>(1);
+		passed &= check(std::vector<double>(prices.begin(), prices.end()) == document.GetColumn<double>(1), "double view");
+	}
+
+	// A cell that doesn't convert only fails when it is read, like GetColumn
+	// would for the whole column, or gives the default value.
+	{
+		const std::string text = "n\n1\n2\nthree\n4\n";
+		const rapidcsv::Document strict = load(text, rapidcsv::LabelParams(0, -1));
+		const auto view = strict.GetColumnView<int>(0);
+		passed &= check(view.size() == 4 && view[0] == 1 && view[1] == 2 && view[3] == 4, "cells around a bad one convert");
+		passed &= check(throws([&] { return view[2]; }), "a bad cell throws when read");
+		passed &= check(throws([&] { return strict.GetColumn<int>(0); }), "GetColumn throws for the same column");
+
+		const rapidcsv::Document lenient = load(text, rapidcsv::LabelParams(0, -1), rapidcsv::ConverterParams(true, 0.0, -1));
+		const auto defaulted = lenient.GetColumnView<int>(0);
+		passed &= check(std::vector<int>(defaulted.begin(), defaulted.end()) == std::vector<int>{ 1, 2, -1, 4 }, "a bad cell gives the default value");
+	}
+
+	// A row too short to have the column throws, as GetColumn does.
+	{
+		const rapidcsv::Document ragged = load("a,b\n1,2\n3\n", rapidcsv::LabelParams(0, -1));
+		const auto view = ragged.GetColumnView(1);
+		passed &= check(view.size() == 2 && view[0] == "2", "ragged column");
+		passed &= check(throws([&] { return view[1]; }), "a short row throws");
+		passed &= check(throws([&] { return ragged.GetColumn<std::string>(1); }), "GetColumn throws for the short row");
+	}
+
+	// An empty document has empty views.
+	{
+		const rapidcsv::Document headerOnly = load("a,b\n", rapidcsv::LabelParams(0, -1));
+		const auto view = headerOnly.GetColumnView(0);
+		passed &= check(view.empty() && view.begin() == view.end(), "no data rows");
+	}
+
+	if (!passed)
+	{
+		return 1;
+	}
+	std::cout << "column views match columns\n";
+	return 0;
+}
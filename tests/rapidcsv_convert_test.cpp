@@ -0,0 +1,163 @@
+// Checks that rapidcsv's from_chars conversion (`ConverterParams` with
+// `mNumericLocale` false) gives the same results as the std::sto* and
+// istringstream conversion it replaced, over a table of edge cases: the
+// value, or the exception type, with and without a default converter.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -Idays_cpp tests/rapidcsv_convert_test.cpp -o rapidcsv_convert_test
+// and run it; it prints every mismatch and exits with 1 if there is any.
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rapidcsv.h"
+
+namespace
+{
+	constexpr long double defaultFloat = -1.5L;
+	constexpr long long defaultInteger = -7;
+
+	// The conversion before from_chars: std::sto* for integers, and for
+	// floating point an istringstream that has to consume the whole cell.
+	template <typename T>
+	T convertWithStreams(const std::string& text)
+	{
+		if constexpr (std::is_same_v<T, int>)
+		{
+			return std::stoi(text);
+		}
+		else if constexpr (std::is_same_v<T, long>)
+		{
+			return std::stol(text);
+		}
+		else if constexpr (std::is_same_v<T, long long>)
+		{
+			return std::stoll(text);
+		}
+		else if constexpr (std::is_same_v<T, unsigned> || std::is_same_v<T, unsigned long>)
+		{
+			return static_cast<T>(std::stoul(text));
+		}
+		else if constexpr (std::is_same_v<T, unsigned long long>)
+		{
+			return std::stoull(text);
+		}
+		else
+		{
+			std::istringstream iss(text);
+			T value{};
+			iss >> value;
+			if (iss.fail() || iss.bad() || !iss.eof())
+			{
+				throw std::invalid_argument("istringstream: no conversion");
+			}
+			return value;
+		}
+	}
+
+	template <typename T>
+	std::string describe(T value)
+	{
+		std::ostringstream text;
+		text.precision(std::numeric_limits<long double>::max_digits10);
+		text << value;
+		return text.str();
+	}
+
+	template <typename T>
+	T defaultValue()
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return static_cast<T>(defaultFloat);
+		}
+		else
+		{
+			return static_cast<T>(defaultInteger);
+		}
+	}
+
+	// The result of a conversion as text: the value, or the exception.
+	template <typename T, typename Convert>
+	std::string outcome(Convert convert, bool hasDefault)
+	{
+		try
+		{
+			return describe(convert());
+		}
+		catch (const std::invalid_argument&)
+		{
+			return hasDefault ? describe(defaultValue<T>()) : "invalid_argument";
+		}
+		catch (const std::out_of_range&)
+		{
+			return hasDefault ? describe(defaultValue<T>()) : "out_of_range";
+		}
+	}
+
+	template <typename T>
+	int compare(const char* type, const std::vector<std::string>& cells)
+	{
+		int mismatches = 0;
+		for (const auto& cell : cells)
+		{
+			for (bool hasDefault : { false, true })
+			{
+				const rapidcsv::ConverterParams params(hasDefault, defaultFloat, defaultInteger, false);
+				const rapidcsv::Converter<T> converter(params);
+				const std::string actual = outcome<T>([&] { T value{}; converter.ToVal(cell, value); return value; }, false);
+				const std::string expected = outcome<T>([&] { return convertWithStreams<T>(cell); }, hasDefault);
+				if (actual != expected)
+				{
+					std::cout << type << " \"" << cell << "\"" << (hasDefault ? " with default" : "")
+						<< ": " << actual << ", expected " << expected << '\n';
+					mismatches++;
+				}
+			}
+		}
+		return mismatches;
+	}
+}
+
+int main()
+{
+	const std::vector<std::string> integers{
+		"0", "12", "-12", "+12", " 12", "\t-3", "12abc", "12 ", "abc", "", "-", "+", "+-1", "-+1", "++1",
+		"0x10", "1.5", "1e3", "007",
+		"2147483647", "2147483648", "-2147483648", "-2147483649",
+		"4294967295", "4294967296", "-1", "-4294967295",
+		"9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616", "-18446744073709551615", "99999999999999999999999",
+	};
+	const std::vector<std::string> floats{
+		"0", "-0", "1.5", "-1.5", "+1.5", " 2.5", "\t2.5", "2.5 ", ".5", "-.5", "+.5", "5.", "00012",
+		"1e10", "1E-5", "1e", "1e+", "1.5x", "1,5", "abc", "", "-", "+", ".", "+-1", "-+1",
+		"inf", "-inf", "infinity", "nan", "NaN", "0x1p3",
+		"3.4e38", "3.5e38", "1e-40", "1e-50", "1.7976931348623157e308", "1e309", "1e-320", "1e400", "-1e400", "1e-400",
+		"0.1", "123456789.123456789", "2.2250738585072014e-308",
+	};
+
+	int mismatches = 0;
+	mismatches += compare<int>("int", integers);
+	mismatches += compare<long>("long", integers);
+	mismatches += compare<long long>("long long", integers);
+	mismatches += compare<unsigned>("unsigned", integers);
+	mismatches += compare<unsigned long>("unsigned long", integers);
+	mismatches += compare<unsigned long long>("unsigned long long", integers);
+	mismatches += compare<float>("float", floats);
+	mismatches += compare<double>("double", floats);
+	mismatches += compare<long double>("long double", floats);
+
+	if (mismatches != 0)
+	{
+		std::cout << mismatches << " mismatches\n";
+		return 1;
+	}
+	std::cout << "all conversions match\n";
+	return 0;
+}
@@ -0,0 +1,98 @@
+// Checks rapidcsv's row labels: `Document::GetRowIdx()` after loading,
+// inserting, removing and renaming rows, and lookups of the same document
+// from several threads at once, which must only read it.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -pthread -Idays_cpp tests/rapidcsv_row_names_test.cpp -o rapidcsv_row_names_test
+// (add -fsanitize=thread to check the lookups for data races) and run it; it
+// prints every failed check and exits with 1 if there is any.
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rapidcsv.h"
+
+namespace
+{
+	bool check(bool condition, const std::string& what)
+	{
+		if (!condition)
+		{
+			std::cout << "failed: " << what << '\n';
+		}
+		return condition;
+	}
+
+	rapidcsv::Document load(const std::string& text, const rapidcsv::LabelParams& labels)
+	{
+		std::istringstream input(text);
+		return rapidcsv::Document(input, labels);
+	}
+}
+
+int main()
+{
+	bool passed = true;
+
+	const std::string text = "name,count\napple,3\npear,12\nplum,-7\n";
+	rapidcsv::Document document = load(text, rapidcsv::LabelParams(0, 0));
+	passed &= check(document.GetRowIdx("apple") == 0 && document.GetRowIdx("plum") == 2, "rows are found after loading");
+	passed &= check(document.GetRowIdx("fig") == -1, "an unknown row isn't found");
+	passed &= check(document.GetCell<int>("count", "pear") == 12, "cell by row and column name");
+
+	document.InsertRow<int>(1, { 5 }, "fig");
+	passed &= check(document.GetRowIdx("fig") == 1 && document.GetRowIdx("pear") == 2 && document.GetRowIdx("plum") == 3,
+		"rows after an inserted one move down");
+
+	document.RemoveRow("apple");
+	passed &= check(document.GetRowIdx("apple") == -1 && document.GetRowIdx("fig") == 0 && document.GetRowIdx("plum") == 2,
+		"rows after a removed one move up");
+
+	document.SetRowName(1, "quince");
+	passed &= check(document.GetRowIdx("quince") == 1 && document.GetCell<int>("count", "quince") == 12, "renamed row");
+
+	const rapidcsv::Document unlabeled = load(text, rapidcsv::LabelParams(0, -1));
+	passed &= check(unlabeled.GetRowIdx("apple") == -1, "no row labels without a label column");
+
+	// Lookups don't modify the document, so threads can share it.
+	{
+		std::string many = "name,value\n";
+		for (int row{ 0 }; row < 10000; row++)
+		{
+			many += "row" + std::to_string(row) + ',' + std::to_string(row * 2) + '\n';
+		}
+		const rapidcsv::Document shared = load(many, rapidcsv::LabelParams(0, 0));
+		std::atomic<int> wrong{ 0 };
+		std::vector<std::thread> threads;
+		for (int thread{ 0 }; thread < 4; thread++)
+		{
+			threads.emplace_back([&, thread]
+				{
+					for (int row{ thread }; row < 10000; row += 3)
+					{
+						if (shared.GetRowIdx("row" + std::to_string(row)) != row
+							|| shared.GetCell<int>("value", "row" + std::to_string(row)) != row * 2)
+						{
+							wrong++;
+						}
+					}
+				});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		passed &= check(wrong == 0, "lookups from several threads");
+	}
+
+	if (!passed)
+	{
+		return 1;
+	}
+	std::cout << "row labels are found\n";
+	return 0;
+}
@@ -0,0 +1,226 @@
+// Checks rapidcsv's `Document::SaveIncremental()` against a full `Save()`.
+//
+// Two documents are loaded from copies of the same file and get the same
+// edits, one after another; after each edit one is saved incrementally and
+// the other in full, and the files must be byte for byte the same. The file
+// is written the way rapidcsv writes it to begin with, since rows that don't
+// change keep the bytes they had. To tell an incremental save from a full
+// one, one byte of the label row of the incrementally saved file is changed
+// on disk: saves that rewrite only what changed keep it, full saves and
+// edits that touch the label row replace it.
+//
+// The last check makes `SaveAtomic()` fail by putting a directory in place
+// of the file, and `SaveIncremental()` then has to write the change made
+// before the failed save.
+//
+// Build from the repository root, for example with
+//   g++ -std=c++20 -O2 -Idays_cpp tests/rapidcsv_save_test.cpp -o rapidcsv_save_test
+// and run it; it prints every failed check and exits with 1 if there is any.
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rapidcsv.h"
+
+namespace
+{
+	const std::string original = "date,category,description\n2024-01-01,work,first\n2024-01-02,home,second\n2024-01-03,work,third\n";
+	const std::string edited = "date,category,description\n2024-01-01,work,first\n2024-01-02,home,changed\n2024-01-03,work,third\n";
+
+	void writeFile(const std::filesystem::path& path, const std::string& text)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+
+	std::string readFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	bool check(bool condition, const std::string& what)
+	{
+		if (!condition)
+		{
+			std::cout << "failed: " << what << '\n';
+		}
+		return condition;
+	}
+
+	struct Edit
+	{
+		std::string name;
+		std::function<void(rapidcsv::Document&)> apply;
+		bool rewritesLabels = false;
+	};
+
+	// The text of a file with a label row and `rows` rows.
+	std::string makeFile(std::size_t rows)
+	{
+		std::string text = "date,category,description\n";
+		for (std::size_t row{ 0 }; row < rows; row++)
+		{
+			text += "2024-01-" + std::to_string(row % 28 + 1) + ",c" + std::to_string(row % 7) + ",event number " + std::to_string(row) + '\n';
+		}
+		return text;
+	}
+
+	// `text` as rapidcsv writes it.
+	std::string canonical(const std::string& text)
+	{
+		std::istringstream input(text);
+		rapidcsv::Document document(input, rapidcsv::LabelParams(0, -1));
+		std::ostringstream output;
+		document.Save(output);
+		return output.str();
+	}
+
+	// UTF-16LE with a byte order mark, which rapidcsv saves in full.
+	std::string toUtf16(const std::string& text)
+	{
+		std::string utf16 = "\xff\xfe";
+		for (char c : text)
+		{
+			utf16 += c;
+			utf16 += '\0';
+		}
+		return utf16;
+	}
+
+	// Runs `edits` on two documents loaded from `text`, and after each one
+	// compares the incrementally saved file with the fully saved one. The
+	// byte at `marker` is changed in the first file, and changed again after
+	// edits that rewrite it; `incremental` says whether the saves are
+	// expected to keep it.
+	bool compareSaves(const std::filesystem::path& directory, const std::string& name, const std::string& text,
+		const std::vector<Edit>& edits, std::size_t marker, bool incremental)
+	{
+		const std::filesystem::path incrementalPath = directory / (name + "-incremental.csv");
+		const std::filesystem::path fullPath = directory / (name + "-full.csv");
+		writeFile(incrementalPath, text);
+		writeFile(fullPath, text);
+		rapidcsv::Document incrementalDocument(incrementalPath.string(), rapidcsv::LabelParams(0, -1));
+		rapidcsv::Document fullDocument(fullPath.string(), rapidcsv::LabelParams(0, -1));
+
+		bool passed = true;
+		for (const Edit& edit : edits)
+		{
+			std::string marked = readFile(incrementalPath);
+			marked.at(marker) = '#';
+			writeFile(incrementalPath, marked);
+
+			edit.apply(incrementalDocument);
+			edit.apply(fullDocument);
+			incrementalDocument.SaveIncremental();
+			fullDocument.Save();
+
+			std::string expected = readFile(fullPath);
+			if (incremental && !edit.rewritesLabels)
+			{
+				expected.at(marker) = '#';
+			}
+			passed &= check(readFile(incrementalPath) == expected, name + ": " + edit.name);
+		}
+		return passed;
+	}
+
+	std::vector<Edit> edits()
+	{
+		using rapidcsv::Document;
+		const std::vector<std::string> added{ "2024-02-01", "c9", "added" };
+		return {
+			{ "nothing changed", [](Document&) {} },
+			{ "append a row", [=](Document& d) { d.InsertRow<std::string>(d.GetRowCount(), added); } },
+			{ "append two rows", [=](Document& d) { d.InsertRow<std::string>(d.GetRowCount(), added); d.InsertRow<std::string>(d.GetRowCount(), added); } },
+			{ "set a cell past the last row", [](Document& d) { d.SetCell<std::string>(2, d.GetRowCount() + 1, "grown"); } },
+			{ "lengthen a cell", [](Document& d) { d.SetCell<std::string>(2, 1, "a much longer description than before"); } },
+			{ "shorten a cell", [](Document& d) { d.SetCell<std::string>(2, 1, "x"); } },
+			{ "shorten the last cell", [](Document& d) { d.SetCell<std::string>(2, d.GetRowCount() - 1, ""); } },
+			{ "quote a cell", [](Document& d) { d.SetCell<std::string>(2, 2, "comma, \"quote\" and\nline break"); } },
+			{ "insert a row", [=](Document& d) { d.InsertRow<std::string>(1, added); } },
+			{ "insert the first row", [=](Document& d) { d.InsertRow<std::string>(0, added); } },
+			{ "remove a row", [](Document& d) { d.RemoveRow(2); } },
+			{ "remove the first row", [](Document& d) { d.RemoveRow(0); } },
+			{ "remove the last row", [](Document& d) { d.RemoveRow(d.GetRowCount() - 1); } },
+			{ "set a whole row", [](Document& d) { d.SetRow<std::string>(1, { "2025-05-05", "new", "replaced row" }); } },
+			{ "change two distant rows", [](Document& d) { d.SetCell<std::string>(1, d.GetRowCount() - 1, "late"); d.SetCell<std::string>(1, 0, "early"); } },
+			{ "set a column", [](Document& d) { auto c = d.GetColumn<std::string>(1); c.back() = "column"; d.SetColumn<std::string>(1, c); }, true },
+			{ "remove all rows but one", [](Document& d) { while (d.GetRowCount() > 1) d.RemoveRow(d.GetRowCount() - 1); } },
+			{ "append after truncating", [=](Document& d) { d.InsertRow<std::string>(d.GetRowCount(), added); } },
+			{ "rename a column", [](Document& d) { d.SetColumnName(2, "what"); }, true },
+			{ "edit after the label row changed", [](Document& d) { d.SetCell<std::string>(0, 0, "2030-01-01"); } },
+		};
+	}
+}
+
+int main()
+{
+	std::random_device random;
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() /
+		("rapidcsv_save_test-" + std::to_string(random()));
+	std::filesystem::create_directory(directory);
+
+	bool passed = true;
+	passed &= compareSaves(directory, "small", canonical(makeFile(5)), edits(), 0, true);
+	// More rows than one write block holds.
+	passed &= compareSaves(directory, "large", canonical(makeFile(20000)), edits(), 0, true);
+	// Without a final line break; the first edit has to add it.
+	std::string unterminated = canonical(makeFile(3));
+	unterminated.pop_back();
+	std::vector<Edit> changes = edits();
+	changes.erase(changes.begin()); // a save without changes leaves the file alone
+	passed &= compareSaves(directory, "unterminated", unterminated, changes, 0, true);
+	// UTF-16 files have no row offsets and are always saved in full.
+	passed &= compareSaves(directory, "utf16", toUtf16(canonical(makeFile(5))), edits(), 2, false);
+
+	{
+		const std::filesystem::path path = directory / "events.csv";
+		writeFile(path, original);
+		rapidcsv::Document document(path.string(), rapidcsv::LabelParams(0, -1));
+		document.SetCell<std::string>(2, 1, "changed");
+
+		// A directory in place of the file makes the rename fail.
+		std::filesystem::remove(path);
+		std::filesystem::create_directory(path);
+		writeFile(path / "blocker", "");
+		bool threw = false;
+		try
+		{
+			document.SaveAtomic();
+		}
+		catch (const std::exception&)
+		{
+			threw = true;
+		}
+		passed &= check(threw, "SaveAtomic throws when the rename fails");
+		passed &= check(!std::filesystem::exists(path.string() + ".tmp"), "SaveAtomic removes its temporary file");
+
+		std::filesystem::remove_all(path);
+		writeFile(path, original);
+		document.SaveIncremental();
+		passed &= check(readFile(path) == edited, "SaveIncremental writes the change after a failed SaveAtomic");
+
+		// The file matches the document again, so further edits are written incrementally.
+		document.SetCell<std::string>(2, 2, "last");
+		document.SaveIncremental();
+		passed &= check(readFile(path) == "date,category,description\n2024-01-01,work,first\n2024-01-02,home,changed\n2024-01-03,work,last\n",
+			"SaveIncremental writes a later change");
+	}
+
+	std::filesystem::remove_all(directory);
+	if (!passed)
+	{
+		return 1;
+	}
+	std::cout << "incremental saves match full saves\n";
+	return 0;
+}